@@ -36,6 +36,7 @@ void set_global_seed(unsigned int s);
  * 
  * This function can be used to specify the solver backend by its name (e.g. Boolector, Z3, etc.).
  * The string "auto" is given or the specified backend is not available, CRAVE will choose the backend automatically.
+ * "LocalSearch" selects a stochastic local search, which falls back to the automatically chosen backend.
  * 
  * \param type Name of the solver, "auto" to let CRAVE decide.
  */
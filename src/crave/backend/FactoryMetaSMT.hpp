@@ -16,6 +16,7 @@ enum SolverTypes {
   Z3,
   CVC4,
   CUDD,
+  LOCAL_SEARCH,
 };
 
 struct FactoryMetaSMT {
@@ -28,6 +29,8 @@ struct FactoryMetaSMT {
   static metaSMTVisitor* getNewInstance(SolverTypes type = solver_type_);
 
   static SolverTypes solver_type_;
+  /// complete solver of LOCAL_SEARCH, selected on first use
+  static SolverTypes local_search_fallback_;
 };
 
 template <SolverTypes solver_type>
@@ -25,7 +25,8 @@ struct Generator {
       var_gen_(new VariableGenerator(*var_ctn_)),
       var_cov_gen_(*var_ctn_),
       vec_gen_(),
-      covered_(false) {}
+      covered_(false),
+      lazy_(false) {}
 
   template <typename Expr>
   explicit Generator(Expr expr)
@@ -35,7 +36,8 @@ struct Generator {
       var_gen_(new VariableGenerator(*var_ctn_)),
       var_cov_gen_(*var_ctn_),
       vec_gen_(),
-      covered_(false) {
+      covered_(false),
+      lazy_(false) {
     (*this)(expr);
   }
 
@@ -43,6 +45,22 @@ struct Generator {
 
   void enable_multithreading();
 
+  /**
+   * \brief Enables or disables lazy solving.
+   *
+   * In lazy mode, next() only marks the partitions as stale. A partition is solved when one of its variables is read
+   * by operator[] or by materialize(), so partitions nobody reads cost nothing. Read references are evaluated at that
+   * time, too. next() only fails for partitions without any solution, a conflict with read references is reported by
+   * materialize() or by an exception of operator[]. Generators with vector constraints always solve eagerly.
+   */
+  void enable_lazy_solving(bool lazy = true) { lazy_ = lazy; }
+
+  /**
+   * \brief Solves all partitions left stale by next() in lazy mode.
+   * \return false if a partition has no solution.
+   */
+  bool materialize();
+
   template <typename Expr>
   Generator& operator()(Expr expr) {
     constr_mng_.makeConstraint(expr, &ctx_);
@@ -112,6 +130,9 @@ struct Generator {
   template <typename T>
   T operator[](Variable<T> const& var) {
     T result;
+    if (!var_gen_->materialize(var.id())) {
+      throw std::runtime_error("Generator constraint unsatisfiable.");
+    }
     if (!var_gen_->read(var, &result)) {
       throw std::runtime_error("Invalid variable read request.");
     }
@@ -141,6 +162,8 @@ struct Generator {
 
   // coverage
   bool covered_;
+
+  bool lazy_;
 };
 
 }  // namespace crave
@@ -0,0 +1,146 @@
+// Copyright 2012-2016 The CRAVE developers, University of Bremen, Germany. All rights reserved.//
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../ir/visitor/metaSMTNodeVisitor.hpp"
+#include "../utils/Evaluator.hpp"
+
+namespace crave {
+
+/**
+ * \brief Solver of the type LOCAL_SEARCH, a stochastic local search over bit-vectors with a complete fallback.
+ *
+ * Each solve starts at the values of the suggestions or at random values and repeatedly repairs a random violated
+ * constraint. One of its variables is set to the candidate that satisfies the most constraints, out of the values
+ * with one bit flipped, the constants of the violated constraint and their neighbors, and random values, which are
+ * evaluated as one batch by the Evaluator. With a small probability a random candidate is taken instead, and the
+ * search restarts at random values every restart_steps.
+ *
+ * The search can only find solutions, so the complete solver takes over after max_steps, and for good once the
+ * searches failed more often than they succeeded. It also solves directly if a constraint is not decided exactly by
+ * the Evaluator, see Evaluator::is_exact(), if there are soft constraints, or if a suggestion is not a value of a
+ * variable, e.g. of a distribution. Assumptions of a value of a variable fix the variable during the search.
+ */
+class LocalSearchSolver : public metaSMTVisitor {
+ public:
+  /// steps of a search before the complete solver is called
+  static unsigned max_steps;
+  /// steps after which a search restarts at random values
+  static unsigned restart_steps;
+  /// percentage of steps that take a random candidate instead of the best one
+  static unsigned noise;
+  /// number of solves of all instances that were answered by the search instead of the complete solver
+  static unsigned long solved_by_search;
+
+  /**
+   * \param complete The solver used if the search fails, owned by this solver.
+   */
+  explicit LocalSearchSolver(metaSMTVisitor* complete);
+
+  virtual void makeAssertion(Node const&);
+  virtual void makeSoftAssertion(Node const&);
+  virtual void makeSuggestion(Node const&);
+  virtual void makeAssumption(Node const&);
+  virtual std::vector<unsigned int> analyseSofts();
+  virtual std::vector<std::vector<unsigned int> > analyseContradiction(std::map<unsigned int, NodePtr> const&);
+  virtual bool solve(bool ignoreSofts = true);
+  virtual bool read(Node const&, AssignResult&);
+  virtual bool read(Node const&, std::string&);
+  virtual bool readVector(const std::vector<VariablePtr>& vec, __rand_vec_base* rand_vec);
+
+ private:
+  virtual void visitNode(Node const&);
+  virtual void visitTerminal(Terminal const&);
+  virtual void visitUnaryExpr(UnaryExpression const&);
+  virtual void visitUnaryOpr(UnaryOperator const&);
+  virtual void visitBinaryExpr(BinaryExpression const&);
+  virtual void visitBinaryOpr(BinaryOperator const&);
+  virtual void visitTernaryExpr(TernaryExpression const&);
+  virtual void visitPlaceholder(Placeholder const&);
+  virtual void visitVariableExpr(VariableExpr const&);
+  virtual void visitConstant(Constant const&);
+  virtual void visitVectorExpr(VectorExpr const&);
+  virtual void visitNotOpr(NotOpr const&);
+  virtual void visitNegOpr(NegOpr const&);
+  virtual void visitComplementOpr(ComplementOpr const&);
+  virtual void visitInside(Inside const&);
+  virtual void visitExtendExpr(ExtendExpression const&);
+  virtual void visitAndOpr(AndOpr const&);
+  virtual void visitOrOpr(OrOpr const&);
+  virtual void visitLogicalAndOpr(LogicalAndOpr const&);
+  virtual void visitLogicalOrOpr(LogicalOrOpr const&);
+  virtual void visitXorOpr(XorOpr const&);
+  virtual void visitEqualOpr(EqualOpr const&);
+  virtual void visitNotEqualOpr(NotEqualOpr const&);
+  virtual void visitLessOpr(LessOpr const&);
+  virtual void visitLessEqualOpr(LessEqualOpr const&);
+  virtual void visitGreaterOpr(GreaterOpr const&);
+  virtual void visitGreaterEqualOpr(GreaterEqualOpr const&);
+  virtual void visitPlusOpr(PlusOpr const&);
+  virtual void visitMinusOpr(MinusOpr const&);
+  virtual void visitMultipliesOpr(MultipliesOpr const&);
+  virtual void visitDevideOpr(DevideOpr const&);
+  virtual void visitModuloOpr(ModuloOpr const&);
+  virtual void visitShiftLeftOpr(ShiftLeftOpr const&);
+  virtual void visitShiftRightOpr(ShiftRightOpr const&);
+  virtual void visitVectorAccess(VectorAccess const&);
+  virtual void visitIfThenElse(IfThenElse const&);
+  virtual void visitForEach(ForEach const&);
+  virtual void visitUnique(Unique const&);
+  virtual void visitBitslice(Bitslice const&);
+  virtual void visitReduction(Reduction const&);
+
+  /**
+   * \brief Collects the variables and constants of a constraint.
+   * \param support Receives the ids of the variables.
+   * \param constants Receives the values of the constants, including the bounds of the ranges of inside().
+   */
+  void collect(Node const& constraint, std::vector<int>* support, std::vector<uint64_t>* constants);
+
+  /**
+   * \brief Searches a solution of the assertions and assumptions.
+   * \return true if a solution is found, which is then stored in model_.
+   */
+  bool search();
+
+  /**
+   * \brief Sets a variable to the best of a batch of candidates for its next value.
+   * \param id The variable.
+   * \param constraints The constraints of the search.
+   * \param occurs The indices of the constraints that contain the variable.
+   * \param constants The constants of the violated constraint.
+   */
+  void move(int id, std::vector<NodePtr> const& constraints, std::vector<unsigned> const& occurs,
+            std::vector<uint64_t> const& constants);
+
+  /**
+   * \brief Passes the assumptions and suggestions to the complete solver, which answers the next solve.
+   */
+  void fallBack();
+
+  std::unique_ptr<metaSMTVisitor> complete_;
+  std::vector<NodePtr> hards_;
+  std::vector<std::vector<int> > hard_supports_;
+  std::vector<std::vector<uint64_t> > hard_constants_;
+  std::vector<NodePtr> assumptions_;  // assumptions and suggestions only hold for the next solve
+  std::vector<NodePtr> suggestions_;
+  std::map<int, std::pair<unsigned, bool> > variables_;  // width and sign of all variables seen so far
+  std::set<int>* support_;  // receive the variables and constants of the visited constraint
+  std::set<uint64_t>* constants_;
+  bool searchable_;  // all assertions are decided exactly by the evaluator and there are no softs
+  bool fallback_;  // the next solve is answered by the complete solver
+  bool searched_;  // the last solve was answered by the search
+  unsigned solved_;
+  unsigned failed_;
+  std::map<int, Constant> model_;
+  Evaluator evaluator_;
+};
+
+}  // namespace crave
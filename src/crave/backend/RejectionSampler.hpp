@@ -0,0 +1,64 @@
+// Copyright 2012-2016 The CRAVE developers, University of Bremen, Germany. All rights reserved.//
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../ir/ConstraintPartition.hpp"
+#include "../ir/VariableContainer.hpp"
+#include "../utils/Evaluator.hpp"
+
+namespace crave {
+
+/**
+ * \brief Solves loosely constrained partitions by drawing random values and checking them.
+ *
+ * Each candidate assigns uniformly distributed values to all variables of the partition except read references
+ * and frozen variables, and is accepted if the Evaluator satisfies all hard constraints with it. Accepted
+ * candidates are uniformly distributed over the solutions. The candidates are evaluated in batches of
+ * CompiledExpression::batch_size.
+ *
+ * Only constraints that the Evaluator decides exactly are supported, see Evaluator::is_exact().
+ */
+class RejectionSampler {
+ public:
+  /**
+   * \brief Checks whether the Evaluator decides all hard constraints of the partition exactly.
+   *
+   * Soft constraints and distributions bias the solutions and are not supported.
+   */
+  static bool applicable(VariableContainer const& vcon, ConstraintPartition const& cp);
+
+  RejectionSampler(VariableContainer const& vcon, ConstraintPartition const& cp);
+
+  /**
+   * \brief Draws up to the given number of candidates and assigns the first one that satisfies the constraints.
+   * \param candidates Maximal number of candidates to check.
+   * \param frozen Ids of frozen variables.
+   * \param values Receives the values of all variables of the partition.
+   * \return false if all candidates are rejected.
+   */
+  bool sample(unsigned candidates, std::set<int> const& frozen, std::map<int, Constant>* values);
+
+  unsigned tried() const { return tried_; }
+  unsigned accepted() const { return accepted_; }
+
+ private:
+  struct Column {
+    int id;
+    unsigned width;
+    bool sign;
+    AssignResult* write_ref;
+    ReferenceExpression* read_ref;
+  };
+
+  std::vector<Column> columns_;
+  std::vector<NodePtr> constraints_;
+  Evaluator evaluator_;
+  unsigned tried_;
+  unsigned accepted_;
+};
+
+}  // namespace crave
@@ -0,0 +1,65 @@
+// Copyright 2012-2016 The CRAVE developers, University of Bremen, Germany. All rights reserved.//
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../ir/ConstraintPartition.hpp"
+#include "../ir/VariableContainer.hpp"
+
+namespace crave {
+
+/**
+ * \brief All solutions of a partition with a tiny solution space.
+ *
+ * The solutions of the hard constraints are enumerated once by an SMT solver with blocking constraints and stored
+ * row by row. A solve is then a random pick of a row that matches the current values of the read references and
+ * frozen variables, so the backend is not involved anymore. Soft constraints and distributions bias the solutions
+ * and are not supported.
+ */
+class SolutionTable {
+ public:
+  /**
+   * \brief Checks whether a partition is small enough to enumerate its solutions.
+   * \param max_bits Maximal sum of the widths of all variables of the partition.
+   */
+  static bool applicable(VariableContainer const& vcon, ConstraintPartition const& cp, unsigned max_bits);
+
+  /**
+   * \brief Enumerates the solutions, gives up if there are more than max_solutions.
+   */
+  SolutionTable(VariableContainer const& vcon, ConstraintPartition const& cp, unsigned max_solutions);
+
+  /**
+   * \brief Checks whether all solutions have been enumerated.
+   */
+  bool complete() const { return complete_; }
+
+  unsigned size() const { return columns_.empty() ? 0 : values_.size() / columns_.size(); }
+
+  /**
+   * \brief Picks a random solution and assigns it to the write references that are not frozen.
+   * \param frozen Ids of frozen variables.
+   * \param values Receives the values of all variables of the partition.
+   * \return false if no solution matches the read references and frozen variables.
+   */
+  bool pick(std::set<int> const& frozen, std::map<int, Constant>* values) const;
+
+ private:
+  struct Column {
+    int id;
+    NodePtr var;
+    unsigned width;
+    bool sign;
+    AssignResult* write_ref;
+    ReferenceExpression* read_ref;
+  };
+
+  std::vector<Column> columns_;
+  std::vector<uint64_t> values_;  // the bits of the values of each solution, one row after another
+  bool complete_;
+};
+
+}  // namespace crave
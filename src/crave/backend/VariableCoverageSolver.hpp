@@ -2,20 +2,41 @@
 
 #pragma once
 
+#include <map>
 #include <string>
 #include <set>
+#include <vector>
 
 #include "VariableSolver.hpp"
 
 namespace crave {
 
 struct VariableCoverageSolver : VariableSolver {
+  // number of uncovered cover constraints checked together in one solver call
+  static unsigned batch_size;
+  // coverage closure mode: extend every solution greedily to hit as many uncovered cover constraints as possible
+  static bool hit_multiple_bins;
+
   VariableCoverageSolver(const VariableContainer& vcon, const ConstraintPartition& cp);
 
   virtual bool solve();
   virtual ~VariableCoverageSolver(){}
 
+ private:
+  typedef std::vector<ConstraintPtr>::const_iterator ConstraintIterator;
+
+  // values of the read references and frozen variables, which decide the reachable cover constraints
+  std::vector<uint64_t> readRefValues() const;
+  // assumes the values of the read references and frozen variables for the next solve
+  void makeAssumptions();
+  ConstraintPtr solveBatch(ConstraintIterator first, ConstraintIterator last);
+  bool solveAll(std::vector<ConstraintPtr> const& hits);
+
  private:
   std::set<std::string> covered_set_;
+  // cover constraints that cannot be hit with the read reference values in unreachable_values_
+  std::set<std::string> unreachable_set_;
+  std::vector<uint64_t> unreachable_values_;
+  std::map<std::string, unsigned> failures_;
 };
 }  // namespace crave
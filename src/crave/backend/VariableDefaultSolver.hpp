@@ -4,15 +4,45 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
 
 #include "VariableSolver.hpp"
+#include "RejectionSampler.hpp"
+#include "SolutionTable.hpp"
+#include "VariableElimination.hpp"
+#include "../utils/Evaluator.hpp"
 
 namespace crave {
 
 struct VariableDefaultSolver : VariableSolver {
   static bool bypass_constraint_analysis;
+  static bool bypass_variable_elimination;
   static unsigned complexity_limit_for_bdd;
+  /**
+   * Partitions of hard constraints with a total complexity below this limit are sampled uniformly from a BDD of the
+   * whole partition instead of calling the SMT solver. 0 disables the BDD sampling, which requires the CUDD backend.
+   */
+  static unsigned complexity_limit_for_partition_bdd;
+  /**
+   * Partitions whose variables have at most this many bits in total and at most solution_table_max_solutions
+   * solutions are enumerated into a SolutionTable when they are solved the second time. 0 disables the tables.
+   * The defaults allow as many solutions as there are assignments of 10 bits, so an enumeration never gives up.
+   * Larger bit limits risk enumerations that are abandoned after solution_table_max_solutions solves.
+   */
+  static unsigned solution_table_max_bits;
+  static unsigned solution_table_max_solutions;
+  /// number of solves of all instances that were answered by a SolutionTable
+  static unsigned long solved_by_table;
+  /**
+   * Number of random candidates the RejectionSampler checks per solve before the SMT solver is called. Partitions
+   * that accept less than one in this many candidates stop sampling. 0 disables the rejection sampling.
+   */
+  static unsigned rejection_sampling_candidates;
+  /// number of solves of all instances that were answered by a RejectionSampler
+  static unsigned long solved_by_sampling;
+  /// number of RejectionSamplers that stopped sampling due to too many rejected candidates
+  static unsigned long dropped_samplers;
 
   VariableDefaultSolver(const VariableContainer& vcon, const ConstraintPartition& cp);
 
@@ -22,8 +52,22 @@ struct VariableDefaultSolver : VariableSolver {
   void analyseConstraints();
   void analyseHards();
   void analyseSofts();
+  void buildPartitionBdd();
+
+  /**
+   * \brief Checks the hard constraints of a partition whose write references are all frozen.
+   * \param result Receives whether the frozen values satisfy the constraints.
+   * \return false if the constraints cannot be evaluated, e.g. due to unassigned temporaries.
+   */
+  bool evaluateFrozen(bool* result);
 
   std::map<int, SolverPtr> bdd_solvers_;
+  SolverPtr partition_bdd_;  // null if the partition is solved by the SMT solver
+  std::shared_ptr<VariableElimination> elimination_;  // null if no variable is eliminated
+  std::shared_ptr<SolutionTable> table_;  // null if the solutions are not enumerated
+  std::shared_ptr<RejectionSampler> sampler_;  // null if candidates are not sampled
+  unsigned num_solves_;
+  Evaluator frozen_evaluator_;
   std::vector<VariableContainer::WriteRefPair> random_write_refs_;
 };
 }  // namespace crave
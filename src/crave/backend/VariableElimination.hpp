@@ -0,0 +1,80 @@
+// Copyright 2012-2016 The CRAVE developers, University of Bremen, Germany. All rights reserved.//
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "../ir/ConstraintPartition.hpp"
+#include "../ir/VariableContainer.hpp"
+#include "../utils/Evaluator.hpp"
+
+namespace crave {
+
+/**
+ * \brief Removes variables that are functionally defined by a constraint from the SMT problem of a partition.
+ *
+ * A hard constraint var == expr defines var, if var is neither a read reference nor involved in a distribution and
+ * expr only reads write and read references (or other defined variables). The defining constraint is dropped and
+ * var is substituted by expr in all other constraints, so the solver neither sees var nor e.g. the adder of a length
+ * field. After solving, the values of the defined variables are computed by an Evaluator.
+ *
+ * Only expressions whose bits of the width of var are computed exactly by the Evaluator are accepted: arithmetic and
+ * bitwise operations, and comparisons and logical operations on terminals. Division, shifts, bit slices etc. keep
+ * their variable in the SMT problem.
+ */
+class VariableElimination {
+ public:
+  VariableElimination(VariableContainer const& vcon, ConstraintPartition const& cp);
+
+  bool empty() const { return definitions_.empty(); }
+
+  bool isEliminated(int id) const { return definitions_.count(id); }
+
+  /**
+   * \brief Checks whether the constraint is dropped because it defines an eliminated variable.
+   */
+  bool isDefinition(UserConstraint const& c) const { return defining_.count(&c); }
+
+  /**
+   * \brief Substitutes all eliminated variables in an expression.
+   */
+  NodePtr substitute(NodePtr const& expr);
+
+  /**
+   * \brief Computes the eliminated variables from the values of the write and read references.
+   *
+   * Must be called after the solution has been read back to the write references. Eliminated write references that
+   * are not frozen receive their values.
+   *
+   * \param frozen Ids of frozen variables.
+   * \param values Receives the values of all eliminated variables.
+   * \return false if a definition cannot be evaluated.
+   */
+  bool evaluate(std::set<int> const& frozen, std::map<int, Constant>* values);
+
+ private:
+  struct Definition {
+    NodePtr var;
+    NodePtr expr;
+    std::set<int> support;  // variables of expr
+    std::set<int> sources;  // variables of the fully substituted expr
+  };
+
+  bool define(int id, NodePtr const& var, NodePtr const& expr);
+  void sort(int id, std::set<int>* visited);
+
+  std::map<int, AssignResult*> write_refs_;
+  std::map<int, ReferenceExpression*> read_refs_;
+  std::set<int> excluded_;  // read references and variables of distributions
+
+  std::map<int, Definition> definitions_;
+  std::set<UserConstraint const*> defining_;
+  std::vector<int> order_;  // definitions after the ones they depend on
+  std::map<int, NodePtr> substituted_;
+
+  Evaluator evaluator_;
+};
+
+}  // namespace crave
@@ -23,6 +23,28 @@ struct VariableGenerator {
 
   virtual bool solve();
 
+  /**
+   * \brief Marks all partitions as stale, i.e. generated but not solved yet.
+   *
+   * Stale partitions are solved by materialize(), so a partition nobody reads is never solved. Read and frozen
+   * references are evaluated when the partition is solved, not when it was marked.
+   *
+   * \param stale false to drop the marks, e.g. after all partitions have been solved by solve().
+   */
+  void invalidate(bool stale = true) { stale_.assign(stale ? solvers_.size() : 0, stale); }
+
+  /**
+   * \brief Solves all stale partitions.
+   * \return false if a partition has no solution.
+   */
+  bool materialize();
+
+  /**
+   * \brief Solves the partition of the given variable if it is stale.
+   * \return false if the partition has no solution.
+   */
+  bool materialize(int id);
+
   template <typename T>
   bool read(const Variable<T>& var, T* value) const {
     for(VarSolverPtr vs : solvers_) {
@@ -36,7 +58,18 @@ struct VariableGenerator {
   std::vector<std::string> getInactiveSofts() const;
 
  protected:
+  /**
+   * \brief Takes the solvers of the current partitions that reappear unchanged in the given ones.
+   *
+   * Solvers are kept by their constraints, so enabling or disabling a constraint only requires new solvers (and a
+   * new constraint analysis) for the partitions that contain it or were merged or split by it.
+   *
+   * \return One entry per given partition, the reused solver or a null pointer.
+   */
+  std::vector<VarSolverPtr> reuseSolvers(std::vector<ConstraintPartition> const& partitions);
+
   const VariableContainer& var_ctn_;
   std::vector<VarSolverPtr> solvers_;
+  std::vector<bool> stale_;  // empty or one flag per solver
 };
 }  // namespace crave
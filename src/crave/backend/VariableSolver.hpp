@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -20,8 +22,13 @@ struct VariableSolver {
   template <typename T>
   bool read(Variable<T> const& var, T* value) {
     if (var_ctn_.variables.find(var.id()) == var_ctn_.variables.end()) return false;
+    std::map<int, Constant>::const_iterator ite = computed_values_.find(var.id());
+    if (ite != computed_values_.end()) {
+      *value = static_cast<T>(ite->second.value());
+      return true;
+    }
     AssignResultToRef<T> result(value);
-    solver_->read(*var_ctn_.variables[var.id()], result);
+    model_->read(*var_ctn_.variables[var.id()], result);
     return true;
   }
 
@@ -31,8 +38,11 @@ struct VariableSolver {
 
  protected:
   VariableContainer var_ctn_;
-  const ConstraintPartition& constr_pttn_;
+  ConstraintPartition constr_pttn_;  // a copy, so the solver can outlive a repartitioning
+  std::set<int> const& frozen_variables_;  // live view, rand_mode() may change between two solves
   SolverPtr solver_;
+  SolverPtr model_;  // holds the last solution, solver_ unless it was sampled by another solver
+  std::map<int, Constant> computed_values_;  // variables not read from model_, computed after solving
 
   std::vector<std::vector<std::string> > contradictions_;
   std::vector<std::string> inactive_softs_;
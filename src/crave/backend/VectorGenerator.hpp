@@ -17,6 +17,9 @@ struct VectorSolver {
   typedef boost::intrusive_ptr<VariableExpr> VariablePtr;
   typedef std::vector<VariablePtr> VectorElements;
 
+  // vectors with bounded index offsets that are larger than this are solved in overlapping windows, 0 disables
+  static unsigned window_size;
+
   explicit VectorSolver(int vector_id);
 
   void addConstraint(VectorConstraintPtr vc);
@@ -25,12 +28,24 @@ struct VectorSolver {
  private:
   void resetSolver(unsigned int const size);
   void buildSolver(unsigned int const size);
+  void buildElementSolver();
+  bool solveElementwise(unsigned int const size, __rand_vec_base* vector);
+  bool solveWindowed(unsigned int const size, __rand_vec_base* vector);
 
  private:
   std::vector<VectorConstraintPtr> constraints_;
   int vector_id_;
   SolverPtr solver_;
   VectorElements vec_elements_;
+  // all constraints only access vec[placeholder]: a single element template is solved once per index
+  bool element_local_;
+  SolverPtr element_solver_;
+  VariablePtr element_;
+  VariablePtr element_idx_;
+  // all constraints only access vec[placeholder + c] with min_offset_ <= c <= max_offset_
+  bool bounded_offsets_;
+  int min_offset_;
+  int max_offset_;
 };
 
 /*
@@ -47,14 +47,38 @@ class crv_array : public crv_object {
    * \brief Gets the sum of the array elements as a CRAVE expression.
    * 
    * The expression can be used in a constraint.
+   * The sum is wide enough to never overflow, e.g. the sum of 40 unsigned chars has 14 bits.
    * 
    * \return sum expression of the elements in the array
    */
-  expression sum() {
-    expression result = value_to_expression(0);
-    for (crv_variable<T>* v : arr_) result = crave::make_expression(result + (*v)());
-    return result;
-  }
+  expression sum() { return reduce(Reduction::SUM); }
+
+  /**
+   * \brief Gets the bitwise and of the array elements as a CRAVE expression.
+   *
+   * The expression can be used in a constraint.
+   *
+   * \return bitwise and of the elements in the array
+   */
+  expression and_reduce() { return reduce(Reduction::AND); }
+
+  /**
+   * \brief Gets the bitwise or of the array elements as a CRAVE expression.
+   *
+   * The expression can be used in a constraint.
+   *
+   * \return bitwise or of the elements in the array
+   */
+  expression or_reduce() { return reduce(Reduction::OR); }
+
+  /**
+   * \brief Gets the bitwise xor of the array elements as a CRAVE expression.
+   *
+   * The expression can be used in a constraint.
+   *
+   * \return bitwise xor of the elements in the array
+   */
+  expression xor_reduce() { return reduce(Reduction::XOR); }
 
   /**
    * \brief Access operator [] for array element.
@@ -62,6 +86,15 @@ class crv_array : public crv_object {
    */
   crv_variable<T>& operator[](unsigned pos) { return *arr_[pos]; }
 
+ private:
+  expression reduce(Reduction::Kind kind) {
+    if (N == 0) return value_to_expression(0);
+    std::vector<NodePtr> operands;
+    for (crv_variable<T>* v : arr_) operands.push_back(boost::proto::value(crave::make_expression((*v)())));
+    return boost::proto::make_expr<boost::proto::tag::terminal, Constraint_Domain>(
+        NodePtr(new Reduction(kind, operands)));
+  }
+
  private:
   std::vector<crv_variable<T>*> arr_; /** < elements of array */
 };
@@ -56,6 +56,13 @@ class crv_constraint_base : public crv_object {
    */
   void recursive_build(Generator& gen) const override;
 
+  /**
+   * \brief Enables or disables the expressions of this constraint in a Generator built by recursive_build().
+   */
+  void update_activation(Generator& gen) const;
+
+  bool recursive_collect(std::vector<crv_constraint_base const*>* constraints) const override;
+
  protected:
   bool active_;
 };
@@ -0,0 +1,70 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#pragma once
+
+#include "../frontend/AssignResult.hpp"
+#include "../ir/Node.hpp"
+#include "../ir/ReferenceExpression.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace crave {
+
+struct Generator;
+class crv_constraint_base;
+
+/**
+ * \brief Generator shared by all objects with structurally equal constraints.
+ *
+ * Instances of a crv_sequence_item subclass carry the same constraints on different variables. Once a second object
+ * with the same constraints is randomized, a Generator on fresh variables is built, so partitioning, constraint
+ * analysis and backend translation happen once for all further objects.
+ * Each variable of the template is a slot that forwards to the write, read or distribution reference of the
+ * instance that is currently randomized. The instances own the template, it is released with the last of them.
+ */
+class crv_constraint_template {
+ public:
+  /**
+   * \brief Binding of one instance to a template.
+   */
+  class instance {
+   public:
+    /**
+     * \brief Redirects the slots of the template to this instance and computes the next solution.
+     */
+    bool next();
+
+   private:
+    friend class crv_constraint_template;
+
+    std::shared_ptr<crv_constraint_template> template_;
+    std::vector<AssignResult*> writes_;
+    std::vector<int> write_ids_;
+    std::vector<ReferenceExpression*> references_;
+  };
+
+  /**
+   * \brief Binds the given constraints to a template, which is created when they are seen the second time.
+   * \return The binding or a null pointer if the constraints are not shared (yet), e.g. due to vector constraints.
+   */
+  static std::shared_ptr<instance> bind(std::vector<crv_constraint_base const*> const& constraints);
+
+  /**
+   * \brief Removes the slots from the variable container, called when the last instance is released.
+   */
+  ~crv_constraint_template();
+
+ private:
+  struct write_slot;
+  struct reference_slot;
+
+  crv_constraint_template() : gen_(), write_slots_(), reference_slots_(), slot_ids_() {}
+
+  std::shared_ptr<Generator> gen_;
+  std::vector<std::shared_ptr<write_slot> > write_slots_;
+  std::vector<std::shared_ptr<reference_slot> > reference_slots_;
+  std::vector<int> slot_ids_;
+};
+
+}  // end namespace crave
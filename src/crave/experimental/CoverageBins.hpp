@@ -8,6 +8,8 @@
 #include "../ir/UserExpression.hpp"
 #include "../utils/Evaluator.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -154,6 +156,14 @@ class crv_abstract_bin {
      */
   void incrementHit() { ++hit_count_; }
 
+  /**
+     * \brief Adds hits recorded elsewhere, e.g. by another run.
+     * \param hits Number of hits to add.
+     */
+  void addHits(uint64_t hits) {
+    hit_count_ = std::min<uint64_t>(uint64_t(hit_count_) + hits, std::numeric_limits<unsigned>::max());
+  }
+
   /**
      * \brief Checks if the bin is covered or not.
      * \return true if the bin is covered, false otherwise.
@@ -194,8 +204,15 @@ class crv_bin : public crv_abstract_bin {
   */
   expression bin_expr() { return bin_expr_; }
 
+  /**
+  * \brief Checks whether the sampled values satisfy the bin expression.
+  * \param eval_ Evaluator holding the sampled values.
+  * \return true if the bin expression evaluates to true.
+  */
+  bool evaluate(Evaluator &eval_) { return eval_.evaluate(bin_expr_) && eval_.result<bool>(); }
+
   void calcHit(Evaluator &eval_) override {
-    if (eval_.evaluate(bin_expr_) && eval_.result<bool>()) {
+    if (evaluate(eval_)) {
       incrementHit();
     }
   }
@@ -213,97 +230,41 @@ class crv_bin : public crv_abstract_bin {
  */
 class crv_transition_bin : public crv_abstract_bin {
  public:
-  crv_transition_bin(std::shared_ptr<crv_transition_fsm_state> rootNode) : root(rootNode) {}
-
-  virtual void calcHit(Evaluator &eval_) override {
-    // First update all pending transitions, only carry those who can continue
-    bool hit = false;
-    std::vector<run> resultRuns;
-    for (run current : runs) {
-      checkRun(current, eval_, resultRuns, hit);
-    }
-    // Second add a new transition on start. If transition is only one constraint long, make a hit
-    if (eval_.evaluate(root->expr) && eval_.result<bool>()) {
-      checkRun(run(root, 0), eval_, resultRuns, hit);
-    }
+  crv_transition_bin(std::shared_ptr<crv_transition_fsm_state> rootNode)
+      : root(rootNode), states_(), active_(), next_(), predicates_() {}
 
-    // Third register only one hit per sample and save carried transitions
-    if (hit) {
-      incrementHit();
-    }
-    runs = resultRuns;
-  }
+  /**
+   * \brief Advances all pending transitions by one sample.
+   *
+   * The FSM is compiled into an NFA whose states are pairs of a FSM state and its repetition count. The set of
+   * active states is a bitset, so any number of overlapping transitions is advanced by a few word operations per
+   * FSM state, and the expression of each FSM state is evaluated at most once per sample.
+   *
+   * @param eval_ Evaluator object to use for calculation of a hit
+   */
+  virtual void calcHit(Evaluator &eval_) override;
 
  private:
-  struct run {
-    std::shared_ptr<crv_transition_fsm_state> state;
-    int count;
-    run(std::shared_ptr<crv_transition_fsm_state> pState, int pCount = 1) : state(pState), count(pCount){};
+  struct nfa_state {
+    expression expr;
+    unsigned first_word;  // bit c of the block starting here is set if the state is active with count c
+    unsigned words;
+    unsigned min;
+    unsigned max;
+    uint64_t last_mask;  // valid bits of the last word of the block
+    int succ;            // index of the successor, -1 for the final state
+    bool keep_on_fail;   // non-consecutive and goto repetitions wait for further hits
+    int guard;           // consecutive state after a non-consecutive one: kept while the guard does not hit again
   };
 
-  void checkRun(run current, Evaluator &eval_, std::vector<run> &resultRuns, bool &hit) {
-    bool wasHit = eval_.evaluate(current.state->expr) && eval_.result<bool>();
-    if (wasHit) {
-      calcHit(eval_, current, resultRuns, hit);
-    } else {
-      if (current.state->type == crv_transition_fsm_state::CONSEC) {
-        hardFail(eval_, current, resultRuns, hit);
-      } else {
-        softFail(eval_, current, resultRuns, hit);
-      }
-    }
-  }
-
-  inline void softFail(Evaluator &eval_, run &current, std::vector<run> &resultRuns, bool &hit) {
-    // Just keep the current transition
-    resultRuns.push_back(current);
-  }
-
-  inline void calcHit(Evaluator &eval_, run &current, std::vector<run> &resultRuns, bool &hit) {
-    current.count++;
-    bool belowMin = current.count < current.state->minHit;
-    bool betweenMinMax = current.count >= current.state->minHit && current.count < current.state->maxHit;
-    if (belowMin) {
-      // Just increment counter
-      resultRuns.push_back(run(current.state, current.count));
-    } else if (betweenMinMax) {
-      // Every hit between min and max continues the transition at the same state
-      resultRuns.push_back(run(current.state, current.count));
-      // But also can lead to the next state in the FSM
-      if (!current.state->succ) {
-        hit = true;
-      } else {
-        // Follow the successor route too
-        resultRuns.push_back(run(current.state->succ, 0));
-        // This adds the ability to find transitions also if they are
-        // sooner finished than anticipated by maxHit.
-      }
-    } else {
-      // When on max we must follow the successor, if exists. Else it is a hit
-      if (!current.state->succ) {
-        hit = true;
-      } else {
-        resultRuns.push_back(run(current.state->succ, 0));
-      }
-    }
-  }
-
-  inline void hardFail(Evaluator &eval_, run &current, std::vector<run> &resultRuns, bool &hit) {
-    // Check if the previous state was an end of a non-consecutive repetition
-    // This is because every node is allowed to fail, if the previous one was
-    // a none-consective node (which forces fails after its end)
-    if (current.state->prev && current.state->prev->type == crv_transition_fsm_state::NON_CONSEC) {
-      // In that case, make sure we did not get another hit of the finished repetition
-      bool hitAgain = eval_.evaluate(current.state->prev->expr) && eval_.result<bool>();
-      if (!hitAgain) {
-        // If we did not hit again, carry run to next sample
-        resultRuns.push_back(current);
-      }
-    }
-  }
+  void compile();
+  bool predicate(unsigned state, Evaluator &eval_);
 
   std::shared_ptr<crv_transition_fsm_state> root;
-  std::vector<run> runs;
+  std::vector<nfa_state> states_;
+  std::vector<uint64_t> active_;
+  std::vector<uint64_t> next_;
+  std::vector<signed char> predicates_;  // per sample cache, -1 if not evaluated yet
 };
 
 }  // end namespace crave
@@ -3,13 +3,19 @@
 #pragma once
 
 #include "CoverageBins.hpp"
+#include "CoverageDatabase.hpp"
+#include "CoverageIndex.hpp"
+#include "CoverageSampleQueue.hpp"
 #include "Expression.hpp"
 #include "Object.hpp"
 #include "Variable.hpp"
 #include "../ir/UserExpression.hpp"
 #include "../utils/Evaluator.hpp"
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace crave {
@@ -28,13 +34,18 @@ class crv_coverpoint : public crv_object {
    * \brief Constructor by name.
    * \param name of the coverpoint, covpt by default.
    */
-  crv_coverpoint(crv_object_name = "covpt") : simple_bins_(), transition_bins_() {}
+  crv_coverpoint(crv_object_name = "covpt") : simple_bins_(), transition_bins_(), index_(), hit_bins_() {}
 
   /**
    * \brief Deleted copy constructor.
    */
   crv_coverpoint(crv_coverpoint const&) = delete;
 
+  /**
+   * \brief Destructor, detaches from the covergroup first as it may still sample into the bins.
+   */
+  ~crv_coverpoint() { detach(); }
+
   std::string obj_kind() const override final { return "crv_coverpoint"; }
 
   /**
@@ -86,10 +97,60 @@ class crv_coverpoint : public crv_object {
     return res;
   }
 
+  /**
+   * \brief Calculates the hits of all bins for the values assigned in the evaluator.
+   *
+   * Simple bins over a single variable are resolved through a crv_bin_index, all others are evaluated.
+   *
+   * \param eval Evaluator holding the sampled values.
+   */
+  void sample(Evaluator& eval) {
+    if (index_.outdated(simple_bins_)) index_.build(simple_bins_);
+    hit_bins_.clear();
+    index_.calcHits(eval, &hit_bins_);
+    for (crv_bin* cb : index_.general_bins()) {
+      if (!cb->evaluate(eval)) continue;
+      cb->incrementHit();
+      hit_bins_.push_back(cb - simple_bins_.data());
+    }
+    for (crv_transition_bin& cb : transition_bins_) cb.calcHit(eval);
+  }
+
+  /**
+   * \brief Returns the positions of the simple bins hit by the last sample.
+   * \return std::vector of indices into simple_bins()
+   */
+  std::vector<unsigned> const& hit_bins() const { return hit_bins_; }
+
+  /**
+   * \brief Adds the hit counts of all bins to a coverage database.
+   * \param db The database, the coverpoint is stored under its fullname.
+   */
+  void save(crv_coverage_db& db) {
+    std::vector<crv_abstract_bin*> bins = all_bins();
+    crv_coverage_db::hit_list hits;
+    for (unsigned i = 0; i < bins.size(); ++i)
+      if (bins[i]->hit_count()) hits.push_back(std::make_pair(i, bins[i]->hit_count()));
+    db.add(fullname(), bins.size(), hits);
+  }
+
+  /**
+   * \brief Adds the hit counts stored for this coverpoint in a coverage database.
+   * \param db The database, e.g. merged from previous runs.
+   */
+  void load(crv_coverage_db const& db) {
+    crv_coverage_db::record const* r = db.find(fullname());
+    if (!r) return;
+    std::vector<crv_abstract_bin*> bins = all_bins();
+    for (std::pair<uint64_t, uint64_t> const& h : r->hits)
+      if (h.first < bins.size()) bins[h.first]->addHits(h.second);
+  }
+
   /**
    * \brief Creates a cross of two coverpoints cp1 and cp2.
    * 
    * Every simple bin of cp1 will be paired with every simple bin of cp2 to create a new bin.
+   * For large coverpoints prefer crv_cross, which does not evaluate each combination on every sample.
    * 
    * \param cp1 First coverpoint of the cross
    * \param cp2 Second coverpoint of the cross
@@ -153,6 +214,159 @@ class crv_coverpoint : public crv_object {
  private:
   std::vector<crv_bin> simple_bins_;
   std::vector<crv_transition_bin> transition_bins_;
+  crv_bin_index index_;
+  std::vector<unsigned> hit_bins_;
+};
+
+/**
+ * \ingroup newAPI
+ * \brief Cross coverage of the simple bins of several coverpoints.
+ *
+ * Unlike crv_coverpoint::cross(), no bin is created for each combination. A sample combines the bins hit by each
+ * coverpoint and counts the resulting tuples in a hash table, so its cost depends on the number of hits instead of
+ * the size of the cross product. The crossed coverpoints must belong to the same covergroup and their bins must not
+ * change after sampling started.
+ */
+class crv_cross : public crv_object {
+ public:
+  /**
+   * \brief Constructor crossing two coverpoints.
+   * \param cp1 First coverpoint of the cross
+   * \param cp2 Second coverpoint of the cross
+   * \param hit_minimum Minimal hit count of each combination.
+   */
+  crv_cross(crv_object_name, crv_coverpoint& cp1, crv_coverpoint& cp2, unsigned hit_minimum = 1)
+      : points_{&cp1, &cp2}, hits_(), hit_minimum_(hit_minimum), covered_count_(0) {}
+
+  /**
+   * \brief Constructor crossing any number of coverpoints.
+   * \param points Coverpoints of the cross
+   * \param hit_minimum Minimal hit count of each combination.
+   */
+  crv_cross(crv_object_name, std::vector<crv_coverpoint*> points, unsigned hit_minimum = 1)
+      : points_(points), hits_(), hit_minimum_(hit_minimum), covered_count_(0) {}
+
+  /**
+   * \brief Deleted copy constructor.
+   */
+  crv_cross(crv_cross const&) = delete;
+
+  /**
+   * \brief Destructor, detaches from the covergroup first as it may still sample into the cross.
+   */
+  ~crv_cross() { detach(); }
+
+  std::string obj_kind() const override final { return "crv_cross"; }
+
+  /**
+   * \brief Counts the combinations of the bins hit by the last sample of the crossed coverpoints.
+   */
+  void sample() {
+    std::vector<unsigned> counts;
+    for (crv_coverpoint* cp : points_) counts.push_back(cp->hit_bins().size());
+    std::vector<unsigned> pos(points_.size(), 0);
+    std::vector<unsigned> bins(points_.size());
+    if (std::find(counts.begin(), counts.end(), 0) != counts.end()) return;
+    do {
+      for (unsigned d = 0; d < points_.size(); ++d) bins[d] = points_[d]->hit_bins()[pos[d]];
+      if (++hits_[key(bins)] == hit_minimum_) ++covered_count_;
+    } while (advance(&pos, counts));
+  }
+
+  /**
+   * \brief Returns how often a combination has been hit.
+   * \param bins Position of a simple bin in each crossed coverpoint.
+   * \return The hit count of the combination.
+   */
+  unsigned hit_count(std::vector<unsigned> const& bins) const {
+    auto ite = hits_.find(key(bins));
+    return ite != hits_.end() ? ite->second : 0;
+  }
+
+  /**
+   * \brief Returns the number of combinations.
+   */
+  uint64_t size() const {
+    uint64_t result = 1;
+    for (crv_coverpoint* cp : points_) result *= cp->simple_bins().size();
+    return result;
+  }
+
+  /**
+   * \brief Returns the number of combinations hit at least the minimal hit count.
+   */
+  uint64_t covered_count() const { return covered_count_; }
+
+  /**
+   * \brief Returns if all combinations are covered.
+   */
+  bool covered() const { return hit_minimum_ == 0 || covered_count_ == size(); }
+
+  /**
+   * \brief Adds the hit counts of all combinations to a coverage database.
+   * \param db The database, the cross is stored under its fullname with the combinations as bin indices.
+   */
+  void save(crv_coverage_db& db) const {
+    crv_coverage_db::hit_list hits(hits_.begin(), hits_.end());
+    std::sort(hits.begin(), hits.end());
+    db.add(fullname(), size(), hits);
+  }
+
+  /**
+   * \brief Adds the hit counts stored for this cross in a coverage database.
+   * \param db The database, e.g. merged from previous runs.
+   */
+  void load(crv_coverage_db const& db) {
+    crv_coverage_db::record const* r = db.find(fullname());
+    if (!r) return;
+    for (std::pair<uint64_t, uint64_t> const& h : r->hits) {
+      if (h.first >= size()) continue;
+      unsigned& count = hits_[h.first];
+      bool was_covered = count >= hit_minimum_;
+      count = std::min<uint64_t>(uint64_t(count) + h.second, std::numeric_limits<unsigned>::max());
+      if (!was_covered && count >= hit_minimum_) ++covered_count_;
+    }
+  }
+
+  /**
+   * \brief Builds the conjunctions of the bin expressions of all uncovered combinations.
+   * \return List of expressions of uncovered combinations
+   */
+  expression_list uncovered_as_list() {
+    expression_list result;
+    std::vector<unsigned> sizes;
+    for (crv_coverpoint* cp : points_) sizes.push_back(cp->simple_bins().size());
+    if (std::find(sizes.begin(), sizes.end(), 0) != sizes.end()) return result;
+    std::vector<unsigned> pos(points_.size(), 0);
+    do {
+      if (hit_count(pos) >= hit_minimum_) continue;
+      expression e = points_[0]->simple_bins()[pos[0]].bin_expr();
+      for (unsigned d = 1; d < points_.size(); ++d)
+        e = make_expression(e && points_[d]->simple_bins()[pos[d]].bin_expr());
+      result.add_expr(e);
+    } while (advance(&pos, sizes));
+    return result;
+  }
+
+ private:
+  static bool advance(std::vector<unsigned>* pos, std::vector<unsigned> const& limits) {
+    for (unsigned d = 0; d < pos->size(); ++d) {
+      if (++(*pos)[d] < limits[d]) return true;
+      (*pos)[d] = 0;
+    }
+    return false;
+  }
+
+  uint64_t key(std::vector<unsigned> const& bins) const {
+    uint64_t k = 0;
+    for (unsigned d = points_.size(); d-- > 0;) k = k * points_[d]->simple_bins().size() + bins[d];
+    return k;
+  }
+
+  std::vector<crv_coverpoint*> points_;
+  std::unordered_map<uint64_t, unsigned> hits_;
+  unsigned hit_minimum_;
+  uint64_t covered_count_;
 };
 
 /**
@@ -166,7 +380,7 @@ class crv_covergroup : public crv_object {
   /**
   * \brief Empty constructor.
   */
-  crv_covergroup() : points_(), vars_(), built_(false), eval_() {}
+  crv_covergroup() : points_(), crosses_(), vars_(), built_(false), eval_(), queue_() {}
 
   /**
    * \brief Deleted copy constructor.
@@ -180,9 +394,47 @@ class crv_covergroup : public crv_object {
    */
   void sample() {
     if (!built_) build();
+    if (queue_) {
+      std::vector<Constant>& values = queue_->reserve();
+      for (unsigned i = 0; i < vars_.size(); ++i) values[i] = vars_[i]->constant_expr();
+      queue_->commit();
+      return;
+    }
     for (auto v : vars_) eval_.assign(v->id(), v->constant_expr());
-    for (crv_coverpoint* cp : points_)
-      for (crv_abstract_bin* cb : cp->all_bins()) cb->calcHit(eval_);
+    sample_bins();
+  }
+
+  /**
+   * \brief Switches to asynchronous sampling.
+   *
+   * sample() then only copies the values of the variables into a ring buffer and a worker thread calculates the
+   * hits of the bins. All methods reading the coverage call flush() first. The pending samples are processed
+   * before the first coverpoint or cross of the covergroup is destroyed.
+   *
+   * \param capacity Number of samples that can be pending before sample() waits for the worker.
+   */
+  void enable_async_sampling(unsigned capacity = 1024) {
+    if (!built_) build();
+    if (queue_) return;
+    // the worker keeps the ids, as the variables may be destroyed before the coverpoints
+    std::vector<unsigned> ids;
+    for (auto v : vars_) ids.push_back(v->id());
+    queue_.reset(new crv_sample_queue(capacity, vars_.size(), [this, ids](std::vector<Constant> const& values) {
+      for (unsigned i = 0; i < ids.size(); ++i) eval_.assign(ids[i], values[i]);
+      sample_bins();
+    }));
+  }
+
+  /**
+   * \brief Processes all pending samples and switches back to synchronous sampling.
+   */
+  void disable_async_sampling() { queue_.reset(); }
+
+  /**
+   * \brief Waits until all samples are processed, a barrier for asynchronous sampling.
+   */
+  void flush() {
+    if (queue_) queue_->flush();
   }
 
   /**
@@ -190,6 +442,7 @@ class crv_covergroup : public crv_object {
    */
   void report() {
     if (!built_) build();
+    flush();
     for (crv_coverpoint* cp : points_) {
       std::cout << cp->obj_kind() << " " << cp->name() << std::endl;
       int c = 0;
@@ -198,6 +451,38 @@ class crv_covergroup : public crv_object {
                   << (cb->covered() ? "covered" : "uncovered") << std::endl;
       }
     }
+    for (crv_cross* cr : crosses_) {
+      std::cout << cr->obj_kind() << " " << cr->name() << std::endl;
+      std::cout << "  " << cr->covered_count() << " of " << cr->size() << " combinations covered" << std::endl;
+    }
+  }
+
+  /**
+   * \brief Adds the hit counts of all coverpoints and crosses to a coverage database.
+   *
+   * Call at the end of a run and write the database with crv_coverage_db::write().
+   *
+   * \param db The database.
+   */
+  void save(crv_coverage_db& db) {
+    if (!built_) build();
+    flush();
+    for (crv_coverpoint* cp : points_) cp->save(db);
+    for (crv_cross* cr : crosses_) cr->save(db);
+  }
+
+  /**
+   * \brief Adds hit counts from a coverage database.
+   *
+   * Bins already closed by previous runs are then covered, so goal() only targets the remaining ones.
+   *
+   * \param db The database, e.g. merged from previous runs with crv_coverage_db::merge_files().
+   */
+  void load(crv_coverage_db const& db) {
+    if (!built_) build();
+    flush();
+    for (crv_coverpoint* cp : points_) cp->load(db);
+    for (crv_cross* cr : crosses_) cr->load(db);
   }
 
   /**
@@ -206,10 +491,12 @@ class crv_covergroup : public crv_object {
    */
   expression_list uncovered_as_list() {
     if (!built_) build();
+    flush();
     expression_list result;
     for (crv_coverpoint* cp : points_)
       for (crv_bin& cb : cp->simple_bins())
         if (!cb.covered()) result.add_expr(cb.bin_expr());
+    for (crv_cross* cr : crosses_) result.join(cr->uncovered_as_list());
     return result;
   }
 
@@ -232,12 +519,32 @@ class crv_covergroup : public crv_object {
    */
   bool covered() {
     if (!built_) build();
+    flush();
     for (crv_coverpoint* cp : points_)
       if (!cp->covered()) return false;
+    for (crv_cross* cr : crosses_)
+      if (!cr->covered()) return false;
     return true;
   }
 
+ protected:
+  /**
+   * \brief Stops asynchronous sampling before a coverpoint or cross of a derived covergroup is destroyed.
+   *
+   * The worker thread writes the bins of the children, so it processes the pending samples and stops while they
+   * still exist.
+   */
+  void remove_child(crv_object* child) override {
+    queue_.reset();
+    crv_object::remove_child(child);
+  }
+
  private:
+  void sample_bins() {
+    for (crv_coverpoint* cp : points_) cp->sample(eval_);
+    for (crv_cross* cr : crosses_) cr->sample();
+  }
+
   void build() {
     built_ = true;
     for (crv_object* obj : children_) {
@@ -249,13 +556,19 @@ class crv_covergroup : public crv_object {
         crv_coverpoint* cp = (crv_coverpoint*)obj;
         points_.push_back(cp);
       }
+      if (obj->obj_kind() == "crv_cross") {
+        crv_cross* cr = (crv_cross*)obj;
+        crosses_.push_back(cr);
+      }
     }
   }
 
   std::vector<crv_coverpoint*> points_;
+  std::vector<crv_cross*> crosses_;
   std::vector<crv_variable_base_*> vars_;
   bool built_;
   Evaluator eval_;
+  std::unique_ptr<crv_sample_queue> queue_;
 };
 
 }  // end namespace crave
@@ -0,0 +1,79 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "stdint.h"
+
+namespace crave {
+
+/**
+ * \ingroup newAPI
+ * \brief Hit counts of coverage constructs, keyed by their fullname and bin index.
+ *
+ * Databases of independent runs are combined by adding the hit counts. The file format is flat and can be memory
+ * mapped: a header, a table of records sorted by name, the names and the sorted (bin, hits) pairs of each record,
+ * all in native byte order. Only bins with hits are stored, so sparse crosses stay small.
+ */
+class crv_coverage_db {
+ public:
+  typedef std::vector<std::pair<uint64_t, uint64_t> > hit_list;  // (bin index, hits), sorted by bin index
+
+  struct record {
+    record() : bins(0), hits() {}
+
+    uint64_t bins;
+    hit_list hits;
+  };
+
+  crv_coverage_db() : records_() {}
+
+  /**
+   * \brief Adds the hit counts of a coverage construct.
+   * \param name Fullname of the construct.
+   * \param bins Number of bins of the construct.
+   * \param hits Hit counts of the bins, sorted by bin index.
+   */
+  void add(std::string const& name, uint64_t bins, hit_list const& hits);
+
+  /**
+   * \brief Returns the record of a coverage construct or NULL if there is none.
+   */
+  record const* find(std::string const& name) const;
+
+  /**
+   * \brief Adds all hit counts of another database.
+   */
+  void merge(crv_coverage_db const& other);
+
+  /**
+   * \brief Writes the database to a file.
+   * \return true on success.
+   */
+  bool write(std::string const& filename) const;
+
+  /**
+   * \brief Reads a database file and adds its hit counts.
+   * \return true on success, false if the file cannot be read or is not a coverage database.
+   */
+  bool read(std::string const& filename);
+
+  /**
+   * \brief Merges any number of database files into one.
+   * \param inputs Files to merge.
+   * \param output File to write the merged database to.
+   * \return true on success.
+   */
+  static bool merge_files(std::vector<std::string> const& inputs, std::string const& output);
+
+  std::map<std::string, record> const& records() const { return records_; }
+
+ private:
+  std::map<std::string, record> records_;
+};
+
+}  // end namespace crave
@@ -0,0 +1,64 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#pragma once
+
+#include "CoverageBins.hpp"
+#include "../utils/Evaluator.hpp"
+
+#include <vector>
+
+namespace crave {
+
+/**
+ * \brief Index over the simple bins of a coverpoint.
+ *
+ * Bins that only test the value of a single variable (comparisons with constants, inside() and boolean
+ * combinations of them) are converted to sets of value intervals. The intervals of all such bins split the value
+ * range of each variable into segments, so a sample finds every hit bin by one binary search instead of evaluating
+ * all bin expressions. Other bins are left to the general evaluation.
+ */
+class crv_bin_index {
+ public:
+  crv_bin_index() : tables_(), general_bins_(), bins_data_(), bins_size_() {}
+
+  /**
+   * \brief Checks whether the index was built for the given bins.
+   */
+  bool outdated(std::vector<crv_bin> const& bins) const {
+    return bins.data() != bins_data_ || bins.size() != bins_size_;
+  }
+
+  /**
+   * \brief Rebuilds the index for the given bins.
+   *
+   * The index refers to the bins by address and must be rebuilt once the vector changes.
+   */
+  void build(std::vector<crv_bin>& bins);
+
+  /**
+   * \brief Increments the hit counter of every indexed bin that contains the assigned value of its variable.
+   * \param eval Evaluator holding the sampled values.
+   * \param hits Receives the positions of the hit bins in the bin vector.
+   */
+  void calcHits(Evaluator const& eval, std::vector<unsigned>* hits);
+
+  /**
+   * \brief Returns the bins that are not indexed and need to be evaluated.
+   */
+  std::vector<crv_bin*> const& general_bins() const { return general_bins_; }
+
+ private:
+  struct table {
+    unsigned var;
+    std::vector<uint64_t> starts;      // first value of each segment, sorted
+    std::vector<unsigned> offsets;     // bins of segment i are bins[offsets[i]] .. bins[offsets[i + 1] - 1]
+    std::vector<crv_bin*> bins;
+  };
+
+  std::vector<table> tables_;
+  std::vector<crv_bin*> general_bins_;
+  crv_bin const* bins_data_;
+  std::size_t bins_size_;
+};
+
+}  // end namespace crave
@@ -0,0 +1,80 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../ir/Node.hpp"
+
+namespace crave {
+
+/**
+ * \brief Single producer, single consumer ring buffer of sampled values with a worker thread.
+ *
+ * The sampling thread copies the values into a preallocated slot and publishes it without locking. The worker
+ * drains all published slots in one batch and hands each to the process function, then blocks on a condition
+ * variable until new samples arrive. If the ring is full, the sampling thread blocks until the worker frees a slot.
+ * The mutex is only taken if the other thread waits.
+ */
+class crv_sample_queue {
+ public:
+  typedef std::function<void(std::vector<Constant> const&)> process_function;
+
+  /**
+   * \brief Starts the worker thread.
+   * \param capacity Number of samples that can be pending, rounded up to a power of two.
+   * \param width Number of values per sample.
+   * \param process Called by the worker thread for each sample in order.
+   */
+  crv_sample_queue(unsigned capacity, unsigned width, process_function process);
+
+  /**
+   * \brief Processes all pending samples and stops the worker thread.
+   */
+  ~crv_sample_queue();
+
+  crv_sample_queue(crv_sample_queue const&) = delete;
+
+  /**
+   * \brief Returns the slot for the next sample, waits while the ring is full.
+   */
+  std::vector<Constant>& reserve();
+
+  /**
+   * \brief Publishes the slot returned by reserve().
+   */
+  void commit();
+
+  /**
+   * \brief Waits until all published samples are processed.
+   */
+  void flush();
+
+ private:
+  void run();
+
+  /**
+   * \brief Blocks the sampling thread until at most max_pending published samples are not processed.
+   */
+  void wait(std::size_t max_pending);
+
+  std::vector<std::vector<Constant> > slots_;
+  std::size_t mask_;
+  process_function process_;
+  std::atomic<std::size_t> head_;  // next slot to process, written by the worker
+  std::atomic<std::size_t> tail_;  // next slot to fill, written by the sampling thread
+  std::atomic<bool> worker_waiting_;
+  std::atomic<bool> sampler_waiting_;
+  bool stop_;  // guarded by mutex_
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::thread worker_;
+};
+
+}  // end namespace crave
@@ -0,0 +1,74 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#pragma once
+
+#include "../ir/Node.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace crave {
+
+/**
+ * \brief Structural key of expressions.
+ *
+ * Two sets of expressions with the same key are equal up to the lifted constants and, if requested, up to a
+ * consistent renaming of their variables. Vectors, placeholders and unique() are not supported.
+ */
+class crv_expression_key {
+ public:
+  /**
+   * \param lift_constants Collect integer constants instead of adding their values to the key.
+   * \param canonical_variables Number variables in order of appearance instead of using their ids.
+   */
+  explicit crv_expression_key(bool lift_constants, bool canonical_variables = false)
+      : key_(), constants_(), variables_(), index_(), max_id_(0), lift_constants_(lift_constants),
+        canonical_variables_(canonical_variables) {}
+
+  /**
+   * \brief Appends an expression to the key.
+   * \return false if the expression is not supported.
+   */
+  bool add(Node const& n);
+
+  template <typename T>
+  void append(T const& v) {
+    key_.append(reinterpret_cast<char const*>(&v), sizeof(v));
+  }
+
+  /**
+   * \brief Checks whether an integer constant is lifted out of the key.
+   *
+   * Non-negative constants are created with the smallest unsigned width that holds their value, so all of them are
+   * lifted. Negative constants only if they have the width of an integer type.
+   */
+  static bool is_lifted(Constant const& c);
+
+  std::string const& str() const { return key_; }
+  std::vector<Constant const*> const& constants() const { return constants_; }
+  std::vector<VariableExpr const*> const& variables() const { return variables_; }
+
+  /**
+   * \brief Position of a variable in variables(), only valid for canonical variables.
+   */
+  unsigned index(unsigned id) const { return index_.at(id); }
+
+  bool contains(unsigned id) const { return index_.count(id); }
+
+  /**
+   * \brief Largest id of the variables, 0 if there are none.
+   */
+  unsigned max_id() const { return max_id_; }
+
+ private:
+  std::string key_;
+  std::vector<Constant const*> constants_;
+  std::vector<VariableExpr const*> variables_;
+  std::unordered_map<unsigned, unsigned> index_;
+  unsigned max_id_;
+  bool lift_constants_;
+  bool canonical_variables_;
+};
+
+}  // end namespace crave
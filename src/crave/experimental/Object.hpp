@@ -6,10 +6,12 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace crave {
 
 struct Generator;
+class crv_constraint_base;
 
 struct crv_object_name;
 class crv_object;
@@ -129,14 +131,37 @@ class crv_object {
   crv_object(const crv_object& other)
       : name_(other.name_), orig_name_(other.orig_name_), parent_(), children_(), fullname_(other.fullname_) {}
 
-  void remove_child(crv_object*);
+  /**
+   * \brief Removes this object from the children of its parent, called by the destructor.
+   *
+   * Subclasses whose members are used by the parent detach at the start of their own destructor.
+   */
+  void detach();
+
+  /**
+   * \brief Removes a child, called when the child is detached.
+   */
+  virtual void remove_child(crv_object*);
 
   virtual void request_rebuild() {
     if (parent_) parent_->request_rebuild();
   }
 
+  /**
+   * \brief Notifies the hierarchy that a constraint was activated or deactivated.
+   */
+  virtual void request_toggle(crv_constraint_base const& c) {
+    if (parent_) parent_->request_toggle(c);
+  }
+
   virtual void recursive_build(Generator& gen) const;
 
+  /**
+   * \brief Collects the active constraints of this subtree in the order of recursive_build().
+   * \return false if the subtree adds anything else to a Generator, e.g. vectors.
+   */
+  virtual bool recursive_collect(std::vector<crv_constraint_base const*>* constraints) const;
+
   std::string name_;                                         /** < name of the object*/
   std::string orig_name_;                                    /** < original name of the object*/
   crv_object* parent_;                                       /** < parent node*/
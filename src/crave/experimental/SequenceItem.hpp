@@ -2,6 +2,11 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "ConstraintTemplate.hpp"
 #include "Coverage.hpp"
 #include "Expression.hpp"
 #include "Object.hpp"
@@ -32,6 +37,14 @@ class crv_sequence_item : public crv_object {
 
   std::string obj_kind() const override final;
 
+  /**
+   * \brief Randomizes all variables of this object.
+   *
+   * Objects with structurally equal constraints, usually the instances of one class, share a single Generator, see
+   * crv_constraint_template. Only the first two of them pay for the analysis of the constraints.
+   *
+   * \return true if a solution is found, false otherwise.
+   */
   bool randomize() override;
 
   /**
@@ -40,6 +53,13 @@ class crv_sequence_item : public crv_object {
    * Adds more constraints that should be used to find the next solution for the random variables.
    * This methods works like randomize() except it takes further inline constraints into consideration.
    * 
+   * The Generator for a set of inline constraints is cached, so calling this method again with constraints that
+   * only differ in the values of their integer constants, e.g. in a loop, does not rebuild and re-partition the
+   * constraints. The constants are bound to the cached Generator as references instead. Since a constant is
+   * stored with the smallest width holding its value, its width is still part of the cache key. Constraints on
+   * variables created since the last call, e.g. read references to local variables, are not cached, as their ids
+   * differ in every call.
+   *
    * \param exprs extra constraints to use for constraint solving
    * \return true if a solution is found, false otherwise.
    */
@@ -61,10 +81,18 @@ class crv_sequence_item : public crv_object {
 
  protected:
   void request_rebuild() override;
+  void request_toggle(crv_constraint_base const& c) override;
 
   bool randomize_with_expr_list(expression_list const&);
+  void build_generator();
+
   std::shared_ptr<Generator> gen_;
+  std::shared_ptr<crv_constraint_template::instance> template_;
   std::shared_ptr<Generator> rand_with_gen_;
+
+  struct cached_generator;
+  std::unordered_map<std::string, std::shared_ptr<cached_generator> > rand_with_cache_;
+  unsigned rand_with_last_id_;  // variables with larger ids were created since the last call
   bool built_;
   bool cloned_;
 };
@@ -182,6 +182,7 @@ class crv_variable<T, typename std::enable_if<std::is_integral<T>::value>::type>
    * generate random value
    */
   bool randomize() override {
+    if (!this->rand_mode()) return true;
     static distribution<T> dist;
     this->value = dist.nextValue();
     return true;
@@ -4,6 +4,7 @@
 
 #include "../frontend/Constraint.hpp"
 #include "../ir/UserExpression.hpp"
+#include "../ir/VariableContainer.hpp"
 #include "Object.hpp"
 
 namespace crave {
@@ -78,6 +79,25 @@ class crv_variable_base : public crv_variable_base_ {
    */
   unsigned id() override { return var.id(); }
 
+  /**
+   * Enable or disable the randomization of this variable. A disabled variable keeps its value and is treated like a
+   * read reference by the constraints, without rebuilding the generator. Vectors have no rand_mode, their elements
+   * are generated on every call.
+   * @param on true to randomize the variable
+   */
+  void rand_mode(bool on) {
+    if (on)
+      variable_container()->frozen_variables.erase(var.id());
+    else
+      variable_container()->frozen_variables.insert(var.id());
+  }
+
+  /**
+   * get the randomization mode
+   * @return false if the randomization is disabled
+   */
+  bool rand_mode() const { return !variable_container()->frozen_variables.count(var.id()); }
+
   /**
    * Bind this variable to another variable.
    * The binding influences the functions bound_expr() and actual_value().
@@ -100,6 +120,8 @@ class crv_variable_base : public crv_variable_base_ {
   crv_variable_base(const crv_variable_base& other)
       : crv_variable_base_(other), var(&value), ref(value), value(other.value), bound_var(other.bound_var) {}
 
+  ~crv_variable_base() { variable_container()->frozen_variables.erase(var.id()); }
+
   /**
    * get the current value
    * @return value
@@ -49,6 +49,8 @@ class crv_vector : public __rand_vec<T>, public crv_object {
   }
   
   void recursive_build(Generator& gen) const override { gen.addVecId(__rand_vec<T>::id()); }
+
+  bool recursive_collect(std::vector<crv_constraint_base const*>*) const override { return false; }
 };
 
 }  // namespace crave
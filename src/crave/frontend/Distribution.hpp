@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <random>
 #include <limits>
 #include <vector>
@@ -59,7 +60,7 @@ struct distribution {
    * 
    * An empty distribution with no ranges corresponds to the whole value range of the base type T.
    */
-  distribution() : ranges_() {}
+  distribution() : ranges_(), ascending_(true) {}
 
   /*!
    * \brief Defines a distribution with a weighted range
@@ -69,7 +70,7 @@ struct distribution {
    * 
    * \param range weighted range for distribution
    */
-  distribution(const weighted_range<T>& range) { addRange(range); }
+  distribution(const weighted_range<T>& range) : ranges_(), ascending_(true) { addRange(range); }
 
   /**
    * \brief Adds another range to the distribution.
@@ -110,7 +111,10 @@ struct distribution {
   /**
    * \brief Deletes all ranges of this distribution
    */
-  void reset() { ranges_.clear(); }
+  void reset() {
+    ranges_.clear();
+    ascending_ = true;
+  }
 
   /**
    * \brief Get all ranges of this distribution.
@@ -131,22 +135,26 @@ struct distribution {
     }
     weighted_range<T> selected = ranges_.back();
     if (ranges_.size() > 1) {
+      // the accumulated weights are non-decreasing, find the first range above r
       uint64_t r = std::uniform_int_distribution<uint64_t>(0, selected.accumWeight_ - 1)(*rng.get());
-      for (unsigned i = 0; i < ranges_.size(); i++)
-        if (r < ranges_[i].accumWeight_) {
-          selected = ranges_[i];
-          break;
-        }
+      selected = *std::upper_bound(ranges_.begin(), ranges_.end(), r, [](uint64_t w, weighted_range<T> const& range) {
+        return w < range.accumWeight_;
+      });
     }
     return uniformly_distributed_value(selected.left_, selected.right_, *rng.get());
   }
 
  protected:
   void addRange(weighted_range<T> wr) {
-    for (unsigned i = 0; i < ranges_.size(); i++)
-      if (ranges_[i].overlap(wr)) {
-        throw std::runtime_error("Overlapping range exists.");
-      }
+    // a range above all existing ranges cannot overlap them, which saves the scan for ranges added in order
+    bool ascending = ranges_.empty() || (ascending_ && ranges_.back().right_ < wr.left_);
+    if (!ascending) {
+      for (unsigned i = 0; i < ranges_.size(); i++)
+        if (ranges_[i].overlap(wr)) {
+          throw std::runtime_error("Overlapping range exists.");
+        }
+    }
+    ascending_ = ascending;
     if (ranges_.empty()) {
       wr.accumWeight_ = wr.weight_;
     } else {
@@ -157,6 +165,7 @@ struct distribution {
 
  protected:
   std::vector<weighted_range<T> > ranges_;
+  bool ascending_;
 };
 
 template <>
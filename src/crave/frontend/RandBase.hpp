@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include "Constraint.hpp"
+#include "../ir/VariableContainer.hpp"
 
 namespace crave {
 
@@ -95,12 +96,35 @@ class randv_base : public rand_base {
    */
   virtual std::string obj_kind() const { return "randv"; }
 
+  /**
+   * \brief Enables or disables the randomization of this variable.
+   *
+   * A disabled variable keeps its current value, which the constraints treat like a read reference. Constraint
+   * partitions without any enabled variable are only checked instead of solved. The generator is not rebuilt.
+   * Vectors have no rand_mode, their elements are generated on every call.
+   *
+   * \param on true to randomize the variable, false to keep its value
+   */
+  void rand_mode(bool on) {
+    if (on)
+      variable_container()->frozen_variables.erase(var.id());
+    else
+      variable_container()->frozen_variables.insert(var.id());
+  }
+
+  /**
+   * \brief Checks whether this variable is randomized.
+   * \return false if the randomization is disabled by rand_mode(false)
+   */
+  bool rand_mode() const { return !variable_container()->frozen_variables.count(var.id()); }
+
  protected:
   explicit randv_base(rand_obj_base* parent) : var(&value) {
     if (parent != 0) parent->add_base_child(this);
   }
 
   randv_base(const randv_base& other) : var(&value), value(other.value) {}
+  ~randv_base() { variable_container()->frozen_variables.erase(var.id()); }
   WriteReference<T> var;
   T value;
 };
@@ -99,6 +99,7 @@ namespace crave {
  public:                                                                                       \
   void gather_values(std::vector<int64_t>* ch) { ch->push_back(static_cast<int64_t>(value)); } \
   bool next() {                                                                                \
+    if (!rand_mode()) return true;                                                             \
     static distribution<Typename> dist;                                                        \
     value = dist.nextValue();                                                                  \
     return true;                                                                               \
@@ -26,6 +26,7 @@ struct to_constant_expr<T, typename boost::enable_if<is_sysc_dt<T> >::type> {
  public:                                                                                          \
   void gather_values(std::vector<int64_t>* ch) { ch->insert(ch->end(), this->value.to_int64()); } \
   bool next() {                                                                                   \
+    if (!this->rand_mode()) return true;                                                          \
     static distribution<int64_t> dist;                                                            \
     this->value = dist.nextValue();                                                               \
     return true;                                                                                  \
@@ -20,12 +20,25 @@ struct ConstraintPartitioner {
 
   void partition();
 
+  /**
+   * \brief Partitions of hard and soft constraints, used by the default solvers.
+   */
   std::vector<ConstraintPartition>& getPartitions();
 
+  /**
+   * \brief Partitions of hard and cover constraints, used by the coverage solvers.
+   */
+  std::vector<ConstraintPartition>& getCoveragePartitions();
+
   std::vector<VectorConstraintPtr>& getVectorConstraints();
 
  private:
-  void maximizePartition(ConstraintPartition* cp, ConstraintList* lc);
+  /**
+   * \brief Moves the constraints of lc that are connected to its first constraint into cp.
+   * \param shared Variables that neither connect constraints nor become part of the support set of cp.
+   */
+  void maximizePartition(ConstraintPartition* cp, ConstraintList* lc, std::set<int> const& shared);
+  void partitionFor(bool coverage, std::vector<ConstraintPartition>* partitions);
 
  private:
   std::set<unsigned> constr_mngs_;
@@ -33,6 +46,7 @@ struct ConstraintPartitioner {
 
   // results
   std::vector<ConstraintPartition> partitions_;
+  std::vector<ConstraintPartition> cov_partitions_;
   std::vector<VectorConstraintPtr> vec_constraints_;
 };
 
@@ -47,6 +47,25 @@ struct Context : boost::proto::callable_context<Context, boost::proto::null_cont
     return (variables_[id] = new VariableExpr(id, width, sign));
   }
 
+  /**
+   * \brief Uniform distribution over the values of an inside() collection with one range per interval.
+   */
+  template <typename Integer>
+  static distribution<Integer> inside_distribution(Inside const& in) {
+    Inside::range_list const& ranges = in.ranges();
+    // the intervals of negative values come last, start with them to add the ranges in ascending order
+    unsigned start = 0;
+    while (start < ranges.size() && !(crave::is_signed<Integer>::value && (ranges[start].first.value() >> 63))) ++start;
+
+    distribution<Integer> dist;
+    for (unsigned i = 0; i < ranges.size(); ++i) {
+      Inside::range_list::value_type const& r = ranges[(start + i) % ranges.size()];
+      dist(weighted_range<Integer>(static_cast<Integer>(r.first.value()), static_cast<Integer>(r.second.value()),
+                                   r.second.value() - r.first.value() + 1));
+    }
+    return dist;
+  }
+
   template <typename value_type>
   result_type new_var(var_tag<value_type> const& tag) {
     unsigned width = bitsize_traits<value_type>::value;
@@ -265,19 +284,17 @@ struct Context : boost::proto::callable_context<Context, boost::proto::null_cont
     bool sign = crave::is_signed<Integer>::value;
 
     std::set<Constant> constants;
-    distribution<Integer> dist;
-    for(CollectionEntry const & i : boost::proto::value(c)) {
-      constants.insert(Constant(i, width, sign));
-      dist(weighted_value<Integer>(i, 1));
-    }
+    for (CollectionEntry const& i : boost::proto::value(c)) constants.insert(Constant(i, width, sign));
 
     unsigned id = new_var_id();
     result_type tmp_var = new_var(id, width, sign);
-    std::shared_ptr<crave::ReferenceExpression> ref_expr(new DistReferenceExpr<Integer>(dist, tmp_var));
+    Inside* inside = new Inside(tmp_var, constants);
+    result_type tmp_inside(inside);
+    std::shared_ptr<crave::ReferenceExpression> ref_expr(
+        new DistReferenceExpr<Integer>(inside_distribution<Integer>(*inside), tmp_var));
     dist_references_.push_back(std::make_pair(id, ref_expr));
 
     result_type val_equal_tmp(new EqualOpr(boost::proto::eval(var_term, *this), tmp_var));
-    result_type tmp_inside(new Inside(tmp_var, constants));
     dist_ref_to_var_map[id] = var_term.id();
     return new LogicalAndOpr(val_equal_tmp, tmp_inside);
   }
@@ -292,19 +309,17 @@ struct Context : boost::proto::callable_context<Context, boost::proto::null_cont
     bool sign = crave::is_signed<Integer>::value;
 
     std::set<Constant> constants;
-    distribution<Integer> dist;
-    for(CollectionEntry const & i : boost::proto::value(c)) {
-      constants.insert(Constant(i, width, sign));
-      dist(weighted_value<Integer>(i, 1));
-    }
+    for (CollectionEntry const& i : boost::proto::value(c)) constants.insert(Constant(i, width, sign));
 
     unsigned id = new_var_id();
     result_type tmp_var = new_var(id, width, sign);
-    std::shared_ptr<crave::ReferenceExpression> ref_expr(new DistReferenceExpr<Integer>(dist, tmp_var));
+    Inside* inside = new Inside(tmp_var, constants);
+    result_type tmp_inside(inside);
+    std::shared_ptr<crave::ReferenceExpression> ref_expr(
+        new DistReferenceExpr<Integer>(inside_distribution<Integer>(*inside), tmp_var));
     dist_references_.push_back(std::make_pair(id, ref_expr));
 
     result_type val_equal_tmp(new EqualOpr(boost::proto::eval(var_term, *this), tmp_var));
-    result_type tmp_inside(new Inside(tmp_var, constants));
     dist_ref_to_var_map[id] = var_term.id();
     return new LogicalAndOpr(val_equal_tmp, tmp_inside);
   }
@@ -5,6 +5,8 @@
 
 #include <ostream>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include <stdint.h>
 
@@ -158,15 +160,36 @@ class ComplementOpr : public UnaryOperator {
 
 class Inside : public UnaryExpression {
  public:
-  Inside(NodePtr v, std::set<Constant> const& c) : UnaryExpression(v), collection_(c) {}
-  Inside(Inside const& i) : UnaryExpression(i), collection_(i.collection()) {}
+  typedef std::vector<std::pair<Constant, Constant> > range_list;
+
+  Inside(NodePtr v, std::set<Constant> const& c) : UnaryExpression(v), collection_(c), ranges_() { makeRanges(); }
+  Inside(Inside const& i) : UnaryExpression(i), collection_(i.collection()), ranges_(i.ranges()) {}
 
   void visit(NodeVisitor* v) const { v->visitInside(*this); }
 
   std::set<Constant> const& collection() const { return collection_; }
 
+  /**
+   * \brief The collection as sorted disjoint intervals [first, second] of consecutive values.
+   *
+   * The intervals are sorted by the 64 bit values of the constants, i.e. negative values follow the positive ones.
+   */
+  range_list const& ranges() const { return ranges_; }
+
  private:
+  void makeRanges() {
+    for (Constant const& c : collection_) {
+      // a signed 64 bit interval must not wrap from the largest positive to the smallest negative value
+      bool wraps = c.sign() && c.value() == (1ULL << 63);
+      if (!ranges_.empty() && ranges_.back().second.value() + 1 == c.value() && !wraps)
+        ranges_.back().second = c;
+      else
+        ranges_.push_back(std::make_pair(c, c));
+    }
+  }
+
   std::set<Constant> collection_;
+  range_list ranges_;
 };
 
 class ExtendExpression : public UnaryExpression {
@@ -423,4 +446,25 @@ class Bitslice : public UnaryExpression {
   int r_, l_;
 };
 
+/**
+ * n-ary reduction (sum, bitwise and/or/xor) over its operands,
+ * sums are widened by FixWidthVisitor so that they cannot overflow
+ */
+class Reduction : public Node {
+ public:
+  enum Kind { SUM, AND, OR, XOR };
+
+  Reduction(Kind k, std::vector<NodePtr> const& operands) : Node(), kind_(k), operands_(operands) {}
+  Reduction(Reduction const& r) : Node(r), kind_(r.kind()), operands_(r.operands()) {}
+
+  void visit(NodeVisitor* v) const { v->visitReduction(*this); }
+
+  Kind kind() const { return kind_; }
+  std::vector<NodePtr> const& operands() const { return operands_; }
+
+ private:
+  Kind kind_;
+  std::vector<NodePtr> operands_;
+};
+
 }  // end namespace crave
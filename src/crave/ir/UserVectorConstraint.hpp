@@ -20,8 +20,14 @@ class UserVectorConstraint : public UserConstraint {
   bool isUnique();
   int getVectorId();
   bool isVectorConstraint();
+  std::set<int> const& indexOffsets();
+  bool hasIrregularIndex();
+  bool hasBoundedOffsets();
+  bool isElementLocal();
 
  protected:
   bool unique_;
+  std::set<int> index_offsets_;
+  bool irregular_index_;
 };
 }  // namespace crave
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <map>
+#include <set>
 #include <utility>
 #include <memory>
 #include <vector>
@@ -22,6 +23,8 @@ struct VariableContainer {
   std::vector<WriteRefPair> write_references;
   std::vector<ReadRefPair> dist_references;
   std::map<int, int> dist_ref_to_var_map;
+  // write references whose variables keep their current value, see rand_mode() of randv and crv_variable
+  std::set<int> frozen_variables;
 };
 
 VariableContainer* variable_container();
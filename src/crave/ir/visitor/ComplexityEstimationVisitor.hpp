@@ -59,6 +59,7 @@ class ComplexityEstimationVisitor : NodeVisitor {
   virtual void visitForEach(ForEach const&);
   virtual void visitUnique(Unique const&);
   virtual void visitBitslice(Bitslice const&);
+  virtual void visitReduction(Reduction const&);
 
   template <typename T>
   void visitSimpleUnaryExpr(const T& object);
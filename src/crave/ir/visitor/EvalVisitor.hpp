@@ -59,6 +59,7 @@ class EvalVisitor : NodeVisitor {
   virtual void visitForEach(ForEach const&);
   virtual void visitUnique(Unique const&);
   virtual void visitBitslice(Bitslice const&);
+  virtual void visitReduction(Reduction const&);
   void pop(stack_entry&);
   void pop2(stack_entry&, stack_entry&);
   void pop3(stack_entry&, stack_entry&, stack_entry&);
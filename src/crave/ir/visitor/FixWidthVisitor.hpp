@@ -12,10 +12,19 @@
 
 namespace crave {
 
+/**
+ * \brief Extends the operands of binary expressions to a common width.
+ *
+ * Comparisons of an operand with a wider constant are not extended but narrowed to the width of the operand, e.g. an
+ * 8 bit variable is compared with an 8 bit constant instead of both being extended to 64 bit. If the constant lies
+ * outside of the range of the operand, the comparison is replaced by its constant result.
+ */
 class FixWidthVisitor : NodeVisitor {
   typedef boost::intrusive_ptr<Node> result_type;
   typedef std::pair<result_type, int> stack_entry;
 
+  enum narrow_result { KEEP_WIDTH, NARROWED, ALWAYS_LESS, ALWAYS_GREATER };
+
  public:
   FixWidthVisitor() : NodeVisitor(), exprStack_() {}
 
@@ -59,10 +68,13 @@ class FixWidthVisitor : NodeVisitor {
   virtual void visitForEach(ForEach const&);
   virtual void visitUnique(Unique const&);
   virtual void visitBitslice(Bitslice const&);
+  virtual void visitReduction(Reduction const&);
   void pop(stack_entry&);
   void pop2(stack_entry&, stack_entry&);
   void pop3(stack_entry&, stack_entry&, stack_entry&);
   void evalBinExpr(BinaryExpression const&, stack_entry&, stack_entry&, bool);
+  void extend(stack_entry&, stack_entry&);
+  narrow_result narrowConstant(stack_entry&, stack_entry&, bool);
   void evalTernExpr(TernaryExpression const&, stack_entry&, stack_entry&, stack_entry&);
 
   template <typename T>
@@ -71,6 +83,8 @@ class FixWidthVisitor : NodeVisitor {
   void visitNumberResultUnaryExpr(const T& object);
   template <typename T>
   void visitBooleanResultBinExpr(const T& object);
+  template <typename T>
+  void visitComparison(const T& object, bool ordering, bool if_less, bool if_greater);
 
  public:
   result_type fixWidth(Node const& expr) {
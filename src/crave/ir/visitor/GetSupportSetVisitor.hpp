@@ -11,7 +11,7 @@ namespace crave {
 
 class GetSupportSetVisitor : public NodeVisitor {
  public:
-  GetSupportSetVisitor() : NodeVisitor(), support_vars() {}
+  GetSupportSetVisitor() : NodeVisitor(), support_vars(), index_offsets(), irregular_index(false) {}
 
  private:
   virtual void visitNode(Node const&);
@@ -53,12 +53,19 @@ class GetSupportSetVisitor : public NodeVisitor {
   virtual void visitForEach(ForEach const&);
   virtual void visitUnique(Unique const&);
   virtual void visitBitslice(Bitslice const&);
+  virtual void visitReduction(Reduction const&);
 
  public:
   std::set<int>& getSupportVars() { return support_vars; }
+  // offsets of all vector accesses of the form vec[placeholder + c], e.g. {0, 1} for vec[_i] < vec[_i + 1]
+  std::set<int>& getIndexOffsets() { return index_offsets; }
+  // true if some vector access is not of the form vec[placeholder + c], e.g. vec[0] or vec[2 * _i]
+  bool hasIrregularIndex() const { return irregular_index; }
 
  private:
   std::set<int> support_vars;
+  std::set<int> index_offsets;
+  bool irregular_index;
 };
 
 }  // end namespace crave
@@ -50,6 +50,7 @@ class ModuloOpr;
 // misc
 class Inside;
 class IfThenElse;
+class Reduction;
 
 // vector
 class VectorAccess;
@@ -101,6 +102,7 @@ class NodeVisitor {
   virtual void visitForEach(ForEach const&) = 0;
   virtual void visitUnique(Unique const&) = 0;
   virtual void visitBitslice(Bitslice const&) = 0;
+  virtual void visitReduction(Reduction const&) = 0;
 };
 
 unsigned int placeholder_bitsize();
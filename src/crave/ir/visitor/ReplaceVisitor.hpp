@@ -14,7 +14,7 @@ namespace crave {
 class ReplaceVisitor : public NodeVisitor {
  public:
   explicit ReplaceVisitor(std::vector<boost::intrusive_ptr<VariableExpr> > *vars)
-      : vec_idx_(), okay_(true), result_(), aux_stack_(), subscript_stack_(), variables_(vars), terminals_() {}
+      : vec_idx_(), idx_var_(), okay_(true), result_(), aux_stack_(), subscript_stack_(), variables_(vars), terminals_() {}
 
   virtual void visitNode(Node const &);
   virtual void visitTerminal(Terminal const &);
@@ -55,11 +55,14 @@ class ReplaceVisitor : public NodeVisitor {
   virtual void visitForEach(ForEach const &);
   virtual void visitUnique(Unique const &);
   virtual void visitBitslice(Bitslice const &);
+  virtual void visitReduction(Reduction const &);
 
   void reset();
   bool okay() { return okay_; }
   NodePtr result() { return result_; }
   void setVecIdx(unsigned int const idx) { vec_idx_ = idx; }
+  // replace placeholders by the given variable instead of the constant vector index
+  void setIdxVar(NodePtr const idx_var) { idx_var_ = idx_var; }
 
  private:
   void updateResult();
@@ -71,6 +74,7 @@ class ReplaceVisitor : public NodeVisitor {
 
  private:
   unsigned int vec_idx_;
+  NodePtr idx_var_;
   bool okay_;
   NodePtr result_;
   std::stack<NodePtr> aux_stack_;
@@ -54,6 +54,7 @@ class ToDotVisitor : public NodeVisitor {
   void visitForEach(ForEach const&);
   void visitUnique(Unique const&);
   void visitBitslice(Bitslice const&);
+  void visitReduction(Reduction const&);
 
  private:
   bool putNode(Node const*);
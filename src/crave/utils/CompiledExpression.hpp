@@ -0,0 +1,131 @@
+// Copyright 2012-2016 The CRAVE developers, University of Bremen, Germany. All rights reserved.//
+
+#pragma once
+
+#include <vector>
+
+#include "../ir/Node.hpp"
+
+namespace crave {
+
+/**
+ * \brief Flat bytecode form of an expression tree.
+ *
+ * An expression is lowered once by the CompileVisitor into a postfix instruction sequence. Variables are
+ * referenced by slot indices into a flat value array owned by the caller, so evaluating the expression again
+ * after new assignments is a single pass over the instructions without any tree walking, map lookups or
+ * allocations. The results match those of the EvalVisitor, see run() for the one deliberate difference.
+ */
+class CompiledExpression {
+ public:
+  struct Value {
+    Value() : value(0), width(1), sign(true), valid(false), bound(false) {}
+    Value(uint64_t v, unsigned w, bool s, bool ok) : value(v), width(w), sign(s), valid(ok), bound(false) {}
+
+    uint64_t value;
+    unsigned width;
+    bool sign;
+    bool valid;
+    bool bound;  // value was propagated by an equality and follows the assigned variable
+  };
+
+  enum OpCode {
+    PUSH_CONSTANT,
+    PUSH_SLOT,
+    BIND_EQUAL,
+    NOT,
+    NEG,
+    COMPLEMENT,
+    INSIDE,
+    EXTEND,
+    BITSLICE,
+    AND,
+    OR,
+    LOGICAL_AND,
+    LOGICAL_OR,
+    XOR,
+    EQUAL,
+    NOT_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    PLUS,
+    MINUS,
+    MULTIPLIES,
+    DEVIDE,
+    MODULO,
+    SHIFT_LEFT,
+    SHIFT_RIGHT,
+    IF_THEN_ELSE,
+    SUM,
+    AND_REDUCE,
+    OR_REDUCE,
+    XOR_REDUCE
+  };
+
+  struct Instruction {
+    Instruction(OpCode o, unsigned x, unsigned y) : op(o), a(x), b(y) {}
+
+    OpCode op;
+    unsigned a;
+    unsigned b;
+  };
+
+  /// maximal number of assignments checked by one runBatch()
+  static const unsigned batch_size = 64;
+
+  CompiledExpression()
+      : code_(), constants_(), sets_(), max_depth_(0), stack_(), batch_stack_(), batch_slots_(), batch_columns_() {}
+
+  /**
+   * \brief Executes the program on the given slot values.
+   *
+   * The slots are not const since an equality between two variables propagates the value of an assigned variable
+   * to an unassigned one, as the EvalVisitor does. Unlike there, a propagated value is refreshed on every run, so
+   * e.g. the temporary variable of an inside() follows later assignments of the constrained variable.
+   *
+   * \param slots Values of the variables, indexed by the slots used during compilation.
+   * \param result Receives the value of the expression.
+   * \return true if the value is defined, i.e. all involved variables are assigned.
+   */
+  bool run(std::vector<Value>* slots, Constant* result) const;
+
+  /**
+   * \brief Executes the program on up to batch_size assignments at once.
+   *
+   * The assignments are stored by column, each instruction runs as one loop over all lanes of its operands, which
+   * the compiler vectorizes, instead of decoding the instruction for every assignment. The signs and definedness of
+   * the lanes are bit masks with one bit per lane. Widths are not tracked, so the result is only the truth value.
+   *
+   * \param slots Values of the variables, indexed by the slots used during compilation. Gives the signs of columns.
+   * \param columns Values of the lanes per slot, null if all lanes use the value of the slot.
+   * \param lanes Number of assignments, between 1 and batch_size.
+   * \return the lanes in which the expression is defined and true, lane i as bit i.
+   */
+  uint64_t runBatch(std::vector<Value> const& slots, std::vector<uint64_t const*> const& columns, unsigned lanes) const;
+
+  unsigned size() const { return code_.size(); }
+
+ private:
+  friend class CompileVisitor;
+
+  struct Lanes {
+    uint64_t value[batch_size];
+    uint64_t sign;
+    uint64_t valid;
+  };
+
+  void bindBatch(unsigned from, unsigned to) const;
+
+  std::vector<Instruction> code_;
+  std::vector<Value> constants_;
+  std::vector<std::vector<uint64_t> > sets_;
+  unsigned max_depth_;
+  mutable std::vector<Value> stack_;
+  mutable std::vector<Lanes> batch_stack_;
+  mutable std::vector<Value> batch_slots_;  // copies of the arguments of runBatch(), modified by equalities
+  mutable std::vector<uint64_t const*> batch_columns_;
+};
+
+}  // end namespace crave
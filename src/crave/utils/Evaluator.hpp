@@ -5,50 +5,105 @@
 #include "stdint.h"
 
 #include <boost/proto/eval.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "../frontend/bitsize_traits.hpp"
-#include "../ir/visitor/EvalVisitor.hpp"
+#include "../ir/visitor/CompileVisitor.hpp"
 #include "../ir/UserExpression.hpp"
+#include "CompiledExpression.hpp"
 
 namespace crave {
 
 template <typename Integer>
-Integer get_result(EvalVisitor const& v) {
-  return static_cast<Integer>(v.result().value());
+Integer get_result(Constant const& c) {
+  return static_cast<Integer>(c.value());
 }
 
 template <>
-bool get_result(EvalVisitor const& v);
+bool get_result(Constant const& c);
 
+/**
+ * \brief Evaluates expressions under an assignment of their variables.
+ *
+ * Each expression is compiled once into a CompiledExpression which is cached by its root node, assigned values are
+ * kept in a flat array indexed by the slots of the variables. Repeated evaluations of the same expression, e.g.
+ * the bins of a covergroup on every sample, therefore only run the flat bytecode.
+ */
 class Evaluator {
-  typedef EvalVisitor::eval_map eval_map;
+  typedef CompileVisitor::slot_map slot_map;
+  typedef std::unordered_map<Node const*, std::pair<NodePtr, CompiledExpression> > program_map;
 
  public:
-  Evaluator() : assignments_(), visitor_(&assignments_) {}
+  Evaluator() : slots_(), values_(), columns_(), column_ptrs_(), programs_(), result_() {}
 
   template <typename var_type, typename value_type>
   void assign(var_type const& var, value_type const& value) {
     unsigned width = bitsize_traits<typename var_type::value_type>::value;
     bool sign = crave::is_signed<typename var_type::value_type>::value;
-    assignments_[var.id()] = Constant(value, width, sign);
+    assign(static_cast<unsigned>(var.id()), Constant(value, width, sign));
   }
 
   void assign(unsigned id, Constant c);
 
+  /**
+   * \brief Assigns one value per lane to a variable for evaluate_batch().
+   *
+   * Variables without lanes keep their assigned value in all lanes, a later assign() removes the lanes again.
+   *
+   * \param values Values of the lanes, signed values sign extended like the value of a Constant.
+   * \param lanes Number of values, at most CompiledExpression::batch_size.
+   */
+  void assign_batch(unsigned id, unsigned width, bool sign, uint64_t const* values, unsigned lanes);
+
   template <typename Expr>
   bool evaluate(Expr expr) {
     return evaluate(make_expression(expr));
   }
   bool evaluate(expression const& expr);
 
+  /**
+   * \brief Evaluates a boolean expression in the given number of lanes at once, see CompiledExpression::runBatch().
+   * \return the lanes in which the expression is defined and true, lane i as bit i.
+   */
+  template <typename Expr>
+  uint64_t evaluate_batch(Expr expr, unsigned lanes) {
+    return evaluate_batch(make_expression(expr), lanes);
+  }
+  uint64_t evaluate_batch(expression const& expr, unsigned lanes);
+
+  /**
+   * \brief Checks whether the Evaluator decides a constraint like the solvers do.
+   *
+   * The Evaluator computes on 64 bit values, so only constraints are supported on which both agree for all
+   * assignments: comparisons and logical operations on variables, constants, bitwise operations and divisions by
+   * positive constants. Orderings require unsigned operands. Arithmetic that may overflow is not supported.
+   */
+  static bool is_exact(Node const& constraint);
+
+  /**
+   * \brief Looks up the value of a variable.
+   * \param id Id of the variable.
+   * \param value Receives the value if the variable is assigned.
+   * \return true if the variable is assigned.
+   */
+  bool assigned_value(unsigned id, Constant* value) const;
+
   template <typename Integer>
   Integer result() const {
-    return get_result<Integer>(visitor_);
+    return get_result<Integer>(result_);
   }
 
  private:
-  eval_map assignments_;
-  EvalVisitor visitor_;
+  CompiledExpression const& compile(NodePtr const& expr);
+
+  slot_map slots_;
+  std::vector<CompiledExpression::Value> values_;
+  std::vector<std::vector<uint64_t> > columns_;  // lanes of the slots, empty if the value is used
+  std::vector<uint64_t const*> column_ptrs_;
+  program_map programs_;
+  Constant result_;
 };
 
 }  // end namespace crave
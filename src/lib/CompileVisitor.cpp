@@ -0,0 +1,202 @@
+// Copyright 2012-2016 The CRAVE developers, University of Bremen, Germany. All rights reserved.//
+
+#include "../crave/ir/visitor/CompileVisitor.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace crave {
+
+void CompileVisitor::compile(Node const& expr, CompiledExpression* target) {
+  target_ = target;
+  target_->code_.clear();
+  target_->constants_.clear();
+  target_->sets_.clear();
+  target_->max_depth_ = 0;
+  depth_ = 0;
+  expr.visit(this);
+  target_ = NULL;
+}
+
+unsigned CompileVisitor::slot(unsigned id) {
+  slot_map::iterator ite = slots_->find(id);
+  if (ite != slots_->end()) return ite->second;
+  unsigned s = slots_->size();
+  slots_->insert(std::make_pair(id, s));
+  return s;
+}
+
+void CompileVisitor::emit(CompiledExpression::OpCode op, unsigned a, unsigned b) {
+  target_->code_.push_back(CompiledExpression::Instruction(op, a, b));
+}
+
+void CompileVisitor::push(CompiledExpression::OpCode op, unsigned a) {
+  emit(op, a);
+  target_->max_depth_ = std::max(target_->max_depth_, ++depth_);
+}
+
+void CompileVisitor::pop(unsigned n) { depth_ -= n; }
+
+void CompileVisitor::emitBinExpr(BinaryExpression const& b, CompiledExpression::OpCode op) {
+  visitBinaryExpr(b);
+  emit(op);
+  pop(1);
+}
+
+void CompileVisitor::visitNode(const Node&) {}
+
+void CompileVisitor::visitTerminal(const Terminal&) {}
+
+void CompileVisitor::visitUnaryExpr(const UnaryExpression& u) { u.child()->visit(this); }
+
+void CompileVisitor::visitUnaryOpr(const UnaryOperator&) {}
+
+void CompileVisitor::visitBinaryExpr(const BinaryExpression& b) {
+  b.lhs()->visit(this);
+  b.rhs()->visit(this);
+}
+
+void CompileVisitor::visitBinaryOpr(const BinaryOperator&) {}
+
+void CompileVisitor::visitTernaryExpr(const TernaryExpression& t) {
+  t.a()->visit(this);
+  t.b()->visit(this);
+  t.c()->visit(this);
+}
+
+void CompileVisitor::visitPlaceholder(const Placeholder&) {
+  throw std::runtime_error("Placeholder is not allowed in CompileVisitor.");
+}
+
+void CompileVisitor::visitVariableExpr(const VariableExpr& v) { push(CompiledExpression::PUSH_SLOT, slot(v.id())); }
+
+void CompileVisitor::visitConstant(const Constant& c) {
+  target_->constants_.push_back(CompiledExpression::Value(c.value(), c.bitsize(), c.sign(), true));
+  push(CompiledExpression::PUSH_CONSTANT, target_->constants_.size() - 1);
+}
+
+void CompileVisitor::visitVectorExpr(const VectorExpr& v) { push(CompiledExpression::PUSH_SLOT, slot(v.id())); }
+
+void CompileVisitor::visitNotOpr(const NotOpr& n) {
+  visitUnaryExpr(n);
+  emit(CompiledExpression::NOT);
+}
+
+void CompileVisitor::visitNegOpr(const NegOpr& n) {
+  visitUnaryExpr(n);
+  emit(CompiledExpression::NEG);
+}
+
+void CompileVisitor::visitComplementOpr(const ComplementOpr& c) {
+  visitUnaryExpr(c);
+  emit(CompiledExpression::COMPLEMENT);
+}
+
+void CompileVisitor::visitInside(const Inside& i) {
+  visitUnaryExpr(i);
+
+  std::vector<uint64_t> values;
+  for (Constant const& c : i.collection()) values.push_back(c.value());
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  target_->sets_.push_back(values);
+
+  emit(CompiledExpression::INSIDE, target_->sets_.size() - 1);
+}
+
+void CompileVisitor::visitExtendExpr(const ExtendExpression& e) {
+  visitUnaryExpr(e);
+  emit(CompiledExpression::EXTEND, e.value());
+}
+
+void CompileVisitor::visitAndOpr(const AndOpr& a) { emitBinExpr(a, CompiledExpression::AND); }
+
+void CompileVisitor::visitOrOpr(const OrOpr& o) { emitBinExpr(o, CompiledExpression::OR); }
+
+void CompileVisitor::visitLogicalAndOpr(const LogicalAndOpr& la) { emitBinExpr(la, CompiledExpression::LOGICAL_AND); }
+
+void CompileVisitor::visitLogicalOrOpr(const LogicalOrOpr& lo) { emitBinExpr(lo, CompiledExpression::LOGICAL_OR); }
+
+void CompileVisitor::visitXorOpr(const XorOpr& x) { emitBinExpr(x, CompiledExpression::XOR); }
+
+void CompileVisitor::visitEqualOpr(const EqualOpr& eq) {
+  // an equality between two variables assigns the unassigned one, see EvalVisitor::visitEqualOpr
+  VariableExpr* v1 = dynamic_cast<VariableExpr*>(eq.lhs().get());
+  VariableExpr* v2 = dynamic_cast<VariableExpr*>(eq.rhs().get());
+  if (v1 && v2 && v1->id() != 0 && v2->id() != 0) emit(CompiledExpression::BIND_EQUAL, slot(v1->id()), slot(v2->id()));
+
+  emitBinExpr(eq, CompiledExpression::EQUAL);
+}
+
+void CompileVisitor::visitNotEqualOpr(const NotEqualOpr& neq) { emitBinExpr(neq, CompiledExpression::NOT_EQUAL); }
+
+void CompileVisitor::visitLessOpr(const LessOpr& l) { emitBinExpr(l, CompiledExpression::LESS); }
+
+void CompileVisitor::visitLessEqualOpr(const LessEqualOpr& le) { emitBinExpr(le, CompiledExpression::LESS_EQUAL); }
+
+void CompileVisitor::visitGreaterOpr(const GreaterOpr& g) { emitBinExpr(g, CompiledExpression::GREATER); }
+
+void CompileVisitor::visitGreaterEqualOpr(const GreaterEqualOpr& ge) {
+  emitBinExpr(ge, CompiledExpression::GREATER_EQUAL);
+}
+
+void CompileVisitor::visitPlusOpr(const PlusOpr& p) { emitBinExpr(p, CompiledExpression::PLUS); }
+
+void CompileVisitor::visitMinusOpr(const MinusOpr& m) { emitBinExpr(m, CompiledExpression::MINUS); }
+
+void CompileVisitor::visitMultipliesOpr(const MultipliesOpr& m) { emitBinExpr(m, CompiledExpression::MULTIPLIES); }
+
+void CompileVisitor::visitDevideOpr(const DevideOpr& d) { emitBinExpr(d, CompiledExpression::DEVIDE); }
+
+void CompileVisitor::visitModuloOpr(const ModuloOpr& m) { emitBinExpr(m, CompiledExpression::MODULO); }
+
+void CompileVisitor::visitShiftLeftOpr(const ShiftLeftOpr& shl) { emitBinExpr(shl, CompiledExpression::SHIFT_LEFT); }
+
+void CompileVisitor::visitShiftRightOpr(const ShiftRightOpr& shr) {
+  emitBinExpr(shr, CompiledExpression::SHIFT_RIGHT);
+}
+
+void CompileVisitor::visitVectorAccess(const VectorAccess&) {
+  throw std::runtime_error("VectorAccess is not allowed in CompileVisitor.");
+}
+
+void CompileVisitor::visitIfThenElse(const IfThenElse& ite) {
+  visitTernaryExpr(ite);
+  emit(CompiledExpression::IF_THEN_ELSE);
+  pop(2);
+}
+
+void CompileVisitor::visitForEach(const ForEach&) {
+  throw std::runtime_error("ForEach is not allowed in CompileVisitor.");
+}
+
+void CompileVisitor::visitUnique(const Unique&) { throw std::runtime_error("Unique is not allowed in CompileVisitor."); }
+
+void CompileVisitor::visitBitslice(const Bitslice& b) {
+  visitUnaryExpr(b);
+  emit(CompiledExpression::BITSLICE, b.l(), b.r());
+}
+
+void CompileVisitor::visitReduction(const Reduction& r) {
+  for (NodePtr const& op : r.operands()) op->visit(this);
+
+  CompiledExpression::OpCode op = CompiledExpression::SUM;
+  switch (r.kind()) {
+    case Reduction::SUM:
+      op = CompiledExpression::SUM;
+      break;
+    case Reduction::AND:
+      op = CompiledExpression::AND_REDUCE;
+      break;
+    case Reduction::OR:
+      op = CompiledExpression::OR_REDUCE;
+      break;
+    case Reduction::XOR:
+      op = CompiledExpression::XOR_REDUCE;
+      break;
+  }
+  emit(op, r.operands().size());
+  pop(r.operands().size() - 1);
+}
+
+}  // end namespace crave
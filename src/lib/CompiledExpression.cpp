@@ -0,0 +1,349 @@
+// Copyright 2012-2016 The CRAVE developers, University of Bremen, Germany. All rights reserved.//
+
+#include "../crave/utils/CompiledExpression.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace crave {
+
+namespace {
+
+typedef CompiledExpression::Value Value;
+
+inline Value arith(Value const& lhs, Value const& rhs, uint64_t v) {
+  return Value(v, lhs.width, lhs.sign || rhs.sign, lhs.valid && rhs.valid);
+}
+
+inline void bind(Value const& from, Value* to) {
+  if (!from.valid || from.bound || (to->valid && !to->bound)) return;
+  *to = from;
+  to->bound = true;
+}
+
+inline Value boolean(Value const& lhs, Value const& rhs, bool v) { return Value(v, 1, true, lhs.valid && rhs.valid); }
+
+}  // namespace
+
+bool CompiledExpression::run(std::vector<Value>* slots, Constant* result) const {
+  if (stack_.size() < max_depth_) stack_.resize(max_depth_);
+  Value* top = stack_.data() - 1;
+  Value* values = slots->data();
+
+  for (Instruction const& i : code_) {
+    switch (i.op) {
+      case PUSH_CONSTANT:
+        *++top = constants_[i.a];
+        break;
+      case PUSH_SLOT:
+        *++top = values[i.a];
+        break;
+      case BIND_EQUAL:
+        bind(values[i.a], values + i.b);
+        bind(values[i.b], values + i.a);
+        break;
+      case NOT:
+        *top = Value(!top->value, 1, true, top->valid);
+        break;
+      case NEG:
+        top->value = -top->value;
+        break;
+      case COMPLEMENT:
+        top->value = ~top->value;
+        break;
+      case INSIDE:
+        *top = Value(std::binary_search(sets_[i.a].begin(), sets_[i.a].end(), top->value), 1, true, top->valid);
+        break;
+      case EXTEND:
+        top->width += i.a;
+        break;
+      case BITSLICE: {
+        unsigned width = i.b - i.a + 1;
+        uint64_t mask = width >= 64 ? ~0ULL : (1ULL << width) - 1;
+        // the EvalVisitor never reports a bitslice as defined
+        *top = Value((top->value >> i.a) & mask, width, false, false);
+        break;
+      }
+      case IF_THEN_ELSE:
+        top -= 2;
+        top[0] = top[0].value ? top[1] : top[2];
+        break;
+      case SUM:
+      case AND_REDUCE:
+      case OR_REDUCE:
+      case XOR_REDUCE: {
+        top -= i.a - 1;
+        Value& acc = top[0];
+        for (unsigned k = 1; k < i.a; ++k) {
+          Value const& v = top[k];
+          if (i.op == SUM) acc.value += v.value;
+          else if (i.op == AND_REDUCE) acc.value &= v.value;
+          else if (i.op == OR_REDUCE) acc.value |= v.value;
+          else acc.value ^= v.value;
+          acc.sign = acc.sign || v.sign;
+          acc.valid = acc.valid && v.valid;
+        }
+        break;
+      }
+      default: {
+        Value const rhs = *top--;
+        Value const lhs = *top;
+        switch (i.op) {
+          case AND:
+            *top = arith(lhs, rhs, lhs.value & rhs.value);
+            break;
+          case OR:
+            *top = arith(lhs, rhs, lhs.value | rhs.value);
+            break;
+          case XOR:
+            *top = arith(lhs, rhs, lhs.value ^ rhs.value);
+            break;
+          case PLUS:
+            *top = arith(lhs, rhs, lhs.value + rhs.value);
+            break;
+          case MINUS:
+            *top = arith(lhs, rhs, lhs.value - rhs.value);
+            break;
+          case MULTIPLIES:
+            *top = arith(lhs, rhs, lhs.value * rhs.value);
+            break;
+          case SHIFT_LEFT:
+            *top = arith(lhs, rhs, lhs.value << rhs.value);
+            break;
+          case SHIFT_RIGHT:
+            *top = arith(lhs, rhs, lhs.value >> rhs.value);
+            break;
+          case DEVIDE:
+          case MODULO:
+            if (rhs.value == 0) {
+              *top = Value();
+            } else if (lhs.sign || rhs.sign) {
+              long long l = static_cast<long long>(lhs.value), r = static_cast<long long>(rhs.value);
+              *top = Value(i.op == DEVIDE ? l / r : l % r, lhs.width, true, lhs.valid && rhs.valid);
+            } else {
+              uint64_t v = i.op == DEVIDE ? lhs.value / rhs.value : lhs.value % rhs.value;
+              *top = Value(v, lhs.width, false, lhs.valid && rhs.valid);
+            }
+            break;
+          case LOGICAL_AND:
+            *top = boolean(lhs, rhs, lhs.value && rhs.value);
+            break;
+          case LOGICAL_OR:
+            *top = boolean(lhs, rhs, lhs.value || rhs.value);
+            break;
+          case EQUAL:
+            *top = boolean(lhs, rhs, lhs.value == rhs.value);
+            break;
+          case NOT_EQUAL:
+            *top = boolean(lhs, rhs, lhs.value != rhs.value);
+            break;
+          case LESS:
+            *top = boolean(lhs, rhs, lhs.value < rhs.value);
+            break;
+          case LESS_EQUAL:
+            *top = boolean(lhs, rhs, lhs.value <= rhs.value);
+            break;
+          case GREATER:
+            *top = boolean(lhs, rhs, lhs.value > rhs.value);
+            break;
+          case GREATER_EQUAL:
+            *top = boolean(lhs, rhs, lhs.value >= rhs.value);
+            break;
+          default:
+            assert(false);
+        }
+      }
+    }
+  }
+
+  assert(top == stack_.data());
+  *result = Constant(top->value, top->width, top->sign);
+  return top->valid;
+}
+
+void CompiledExpression::bindBatch(unsigned from, unsigned to) const {
+  // as bind(), a column counts as assigned
+  Value const& f = batch_slots_[from];
+  Value& t = batch_slots_[to];
+  if (f.bound || (!f.valid && !batch_columns_[from])) return;
+  if (!t.bound && (t.valid || batch_columns_[to])) return;
+  t = f;
+  t.bound = true;
+  batch_columns_[to] = batch_columns_[from];
+}
+
+uint64_t CompiledExpression::runBatch(std::vector<Value> const& slots, std::vector<uint64_t const*> const& columns,
+                                      unsigned lanes) const {
+  assert(lanes > 0 && lanes <= batch_size && columns.size() >= slots.size());
+  uint64_t const all = lanes == batch_size ? ~0ULL : (1ULL << lanes) - 1;
+  if (batch_stack_.size() < max_depth_) batch_stack_.resize(max_depth_);
+  batch_slots_ = slots;
+  batch_columns_.assign(columns.begin(), columns.begin() + slots.size());
+  Lanes* top = batch_stack_.data() - 1;
+
+  for (Instruction const& i : code_) {
+    switch (i.op) {
+      case PUSH_CONSTANT: {
+        Value const& c = constants_[i.a];
+        ++top;
+        std::fill(top->value, top->value + lanes, c.value);
+        top->sign = c.sign ? all : 0;
+        top->valid = c.valid ? all : 0;
+        break;
+      }
+      case PUSH_SLOT: {
+        Value const& v = batch_slots_[i.a];
+        uint64_t const* column = batch_columns_[i.a];
+        ++top;
+        if (column) {
+          std::copy(column, column + lanes, top->value);
+        } else {
+          std::fill(top->value, top->value + lanes, v.value);
+        }
+        top->sign = v.sign ? all : 0;
+        top->valid = v.valid || column ? all : 0;
+        break;
+      }
+      case BIND_EQUAL:
+        bindBatch(i.a, i.b);
+        bindBatch(i.b, i.a);
+        break;
+      case NOT:
+        for (unsigned k = 0; k < lanes; ++k) top->value[k] = !top->value[k];
+        top->sign = all;
+        break;
+      case NEG:
+        for (unsigned k = 0; k < lanes; ++k) top->value[k] = -top->value[k];
+        break;
+      case COMPLEMENT:
+        for (unsigned k = 0; k < lanes; ++k) top->value[k] = ~top->value[k];
+        break;
+      case INSIDE: {
+        std::vector<uint64_t> const& set = sets_[i.a];
+        for (unsigned k = 0; k < lanes; ++k) top->value[k] = std::binary_search(set.begin(), set.end(), top->value[k]);
+        top->sign = all;
+        break;
+      }
+      case EXTEND:
+        break;
+      case BITSLICE:
+        top->sign = 0;
+        top->valid = 0;
+        break;
+      case IF_THEN_ELSE: {
+        top -= 2;
+        uint64_t taken = 0;
+        for (unsigned k = 0; k < lanes; ++k) taken |= static_cast<uint64_t>(top[0].value[k] != 0) << k;
+        for (unsigned k = 0; k < lanes; ++k) top[0].value[k] = top[0].value[k] ? top[1].value[k] : top[2].value[k];
+        top[0].sign = (top[1].sign & taken) | (top[2].sign & ~taken);
+        top[0].valid = (top[1].valid & taken) | (top[2].valid & ~taken);
+        break;
+      }
+      case SUM:
+      case AND_REDUCE:
+      case OR_REDUCE:
+      case XOR_REDUCE: {
+        top -= i.a - 1;
+        uint64_t* acc = top[0].value;
+        for (unsigned n = 1; n < i.a; ++n) {
+          uint64_t const* v = top[n].value;
+          if (i.op == SUM) {
+            for (unsigned k = 0; k < lanes; ++k) acc[k] += v[k];
+          } else if (i.op == AND_REDUCE) {
+            for (unsigned k = 0; k < lanes; ++k) acc[k] &= v[k];
+          } else if (i.op == OR_REDUCE) {
+            for (unsigned k = 0; k < lanes; ++k) acc[k] |= v[k];
+          } else {
+            for (unsigned k = 0; k < lanes; ++k) acc[k] ^= v[k];
+          }
+          top[0].sign |= top[n].sign;
+          top[0].valid &= top[n].valid;
+        }
+        break;
+      }
+      default: {
+        Lanes const& rhs = *top--;
+        uint64_t* l = top->value;
+        uint64_t const* r = rhs.value;
+        switch (i.op) {
+          case AND:
+            for (unsigned k = 0; k < lanes; ++k) l[k] &= r[k];
+            break;
+          case OR:
+            for (unsigned k = 0; k < lanes; ++k) l[k] |= r[k];
+            break;
+          case XOR:
+            for (unsigned k = 0; k < lanes; ++k) l[k] ^= r[k];
+            break;
+          case PLUS:
+            for (unsigned k = 0; k < lanes; ++k) l[k] += r[k];
+            break;
+          case MINUS:
+            for (unsigned k = 0; k < lanes; ++k) l[k] -= r[k];
+            break;
+          case MULTIPLIES:
+            for (unsigned k = 0; k < lanes; ++k) l[k] *= r[k];
+            break;
+          case SHIFT_LEFT:
+            for (unsigned k = 0; k < lanes; ++k) l[k] <<= r[k];
+            break;
+          case SHIFT_RIGHT:
+            for (unsigned k = 0; k < lanes; ++k) l[k] >>= r[k];
+            break;
+          case DEVIDE:
+          case MODULO: {
+            uint64_t const sign = top->sign | rhs.sign;
+            for (unsigned k = 0; k < lanes; ++k) {
+              if (r[k] == 0) {
+                top->valid &= ~(1ULL << k);
+              } else if ((sign >> k) & 1) {
+                long long x = static_cast<long long>(l[k]), y = static_cast<long long>(r[k]);
+                l[k] = i.op == DEVIDE ? x / y : x % y;
+              } else {
+                l[k] = i.op == DEVIDE ? l[k] / r[k] : l[k] % r[k];
+              }
+            }
+            break;
+          }
+          case LOGICAL_AND:
+            for (unsigned k = 0; k < lanes; ++k) l[k] = l[k] && r[k];
+            break;
+          case LOGICAL_OR:
+            for (unsigned k = 0; k < lanes; ++k) l[k] = l[k] || r[k];
+            break;
+          case EQUAL:
+            for (unsigned k = 0; k < lanes; ++k) l[k] = l[k] == r[k];
+            break;
+          case NOT_EQUAL:
+            for (unsigned k = 0; k < lanes; ++k) l[k] = l[k] != r[k];
+            break;
+          case LESS:
+            for (unsigned k = 0; k < lanes; ++k) l[k] = l[k] < r[k];
+            break;
+          case LESS_EQUAL:
+            for (unsigned k = 0; k < lanes; ++k) l[k] = l[k] <= r[k];
+            break;
+          case GREATER:
+            for (unsigned k = 0; k < lanes; ++k) l[k] = l[k] > r[k];
+            break;
+          case GREATER_EQUAL:
+            for (unsigned k = 0; k < lanes; ++k) l[k] = l[k] >= r[k];
+            break;
+          default:
+            assert(false);
+        }
+        // comparisons and logical operations give booleans, which are signed
+        bool boolean = i.op == LOGICAL_AND || i.op == LOGICAL_OR || (i.op >= EQUAL && i.op <= GREATER_EQUAL);
+        top->sign = boolean ? all : top->sign | rhs.sign;
+        top->valid &= rhs.valid;
+      }
+    }
+  }
+
+  assert(top == batch_stack_.data());
+  uint64_t result = 0;
+  for (unsigned k = 0; k < lanes; ++k) result |= static_cast<uint64_t>(top->value[k] != 0) << k;
+  return result & top->valid;
+}
+
+}  // end namespace crave
@@ -195,4 +195,17 @@ void ComplexityEstimationVisitor::visitBitslice(const Bitslice& b) {
   exprStack_.push(std::make_pair(new Bitslice(e.first, b.r(), b.l()), b.r() - b.l() + 1));
 }
 
+void ComplexityEstimationVisitor::visitReduction(const Reduction& r) {
+  std::vector<NodePtr> operands;
+  unsigned int complexity = 0;
+  for(NodePtr const& n : r.operands()) {
+    n->visit(this);
+    stack_entry e;
+    pop(e);
+    operands.push_back(e.first);
+    complexity += e.second;
+  }
+  exprStack_.push(std::make_pair(new Reduction(r.kind(), operands), complexity));
+}
+
 }  // end namespace crave
@@ -78,7 +78,11 @@ ConstraintPtr ConstraintManager::makeConstraint(std::string const& name, int c_i
   ConstraintPtr c;
 
   if (boost::dynamic_pointer_cast<ForEach>(n) != 0) {
-    c = std::make_shared<UserVectorConstraint>(c_id, n, name, gssv.getSupportVars(), false, soft, cover);
+    std::shared_ptr<UserVectorConstraint> vc =
+        std::make_shared<UserVectorConstraint>(c_id, n, name, gssv.getSupportVars(), false, soft, cover);
+    vc->index_offsets_ = gssv.getIndexOffsets();
+    vc->irregular_index_ = gssv.hasIrregularIndex();
+    c = vc;
   } else if (boost::dynamic_pointer_cast<Unique>(n) != 0) {
     c = std::make_shared<UserVectorConstraint>(c_id, n, name, gssv.getSupportVars(), true, soft, cover);
   } else {
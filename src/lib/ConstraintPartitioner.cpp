@@ -9,6 +9,7 @@ void ConstraintPartitioner::reset() {
   constr_mngs_.clear();
   constraints_.clear();
   partitions_.clear();
+  cov_partitions_.clear();
   vec_constraints_.clear();
 }
 
@@ -27,11 +28,9 @@ void ConstraintPartitioner::mergeConstraints(const ConstraintManager& mng) {
 }
 
 void ConstraintPartitioner::partition() {
-  while (!constraints_.empty()) {
-    ConstraintPartition cp;
-    maximizePartition(&cp, &constraints_);
-    partitions_.push_back(cp);
-  }
+  partitionFor(false, &partitions_);
+  partitionFor(true, &cov_partitions_);
+  constraints_.clear();
   LOG(INFO) << "Partition results of set(s)";
   for(unsigned id : constr_mngs_) { LOG(INFO) << " " << id; }
   LOG(INFO) << ": ";
@@ -42,16 +41,55 @@ void ConstraintPartitioner::partition() {
   LOG(INFO) << "  " << partitions_.size() << " constraint partition(s):";
   unsigned cnt = 0;
   for(ConstraintPartition & cp : partitions_) { LOG(INFO) << "    #" << ++cnt << ": " << cp; }
+  LOG(INFO) << "  " << cov_partitions_.size() << " coverage partition(s)";
+}
+
+void ConstraintPartitioner::partitionFor(bool coverage, std::vector<ConstraintPartition>* partitions) {
+  // the default solvers ignore cover constraints and the coverage solvers ignore soft constraints, so these only
+  // take part if they have variables of their own, which must be generated nonetheless
+  auto ignored = [coverage](ConstraintPtr c) { return coverage ? c->isSoft() : c->isCover(); };
+  std::set<int> vars;
+  for(ConstraintPtr c : constraints_) {
+    if (!ignored(c)) vars.insert(c->support_vars_.begin(), c->support_vars_.end());
+  }
+  ConstraintList lc, owners;
+  for(ConstraintPtr c : constraints_) {
+    if (!ignored(c))
+      lc.push_back(c);
+    else if (!std::includes(vars.begin(), vars.end(), c->support_vars_.begin(), c->support_vars_.end()))
+      owners.push_back(c);
+  }
+
+  while (!lc.empty()) {
+    ConstraintPartition cp;
+    maximizePartition(&cp, &lc, std::set<int>());
+    partitions->push_back(cp);
+  }
+  // the variables of their own are generated in separate partitions, which do not merge with the partitions of the
+  // remaining variables
+  while (!owners.empty()) {
+    ConstraintPartition cp;
+    maximizePartition(&cp, &owners, vars);
+    partitions->push_back(cp);
+  }
 }
 
 std::vector<ConstraintPartition>& ConstraintPartitioner::getPartitions() { return partitions_; }
 
+std::vector<ConstraintPartition>& ConstraintPartitioner::getCoveragePartitions() { return cov_partitions_; }
+
 std::vector<VectorConstraintPtr>& ConstraintPartitioner::getVectorConstraints() { return vec_constraints_; }
 
-void ConstraintPartitioner::maximizePartition(ConstraintPartition* cp, ConstraintList* lc) {
+void ConstraintPartitioner::maximizePartition(ConstraintPartition* cp, ConstraintList* lc,
+                                              std::set<int> const& shared) {
+  auto addSupport = [cp, &shared](ConstraintPtr c) {
+    for(int id : c->support_vars_) {
+      if (!shared.count(id)) cp->support_vars_.insert(id);
+    }
+  };
   ConstraintPtr c = lc->front();
   lc->pop_front();
-  cp->support_vars_ = c->support_vars_;
+  addSupport(c);
   cp->add(c);
   while (true) {
     bool changed = false;
@@ -65,7 +103,7 @@ void ConstraintPartitioner::maximizePartition(ConstraintPartition* cp, Constrain
       if (!v_intersection.empty()) {
         changed = true;
         cp->add(c);
-        cp->support_vars_.insert(c->support_vars_.begin(), c->support_vars_.end());
+        addSupport(c);
         ite = lc->erase(ite);
       } else {
         ++ite;
@@ -81,10 +81,8 @@ void EvalVisitor::visitInside(const Inside& i) {
   stack_entry e;
   pop(e);
 
-  bool result = false;
-
-  for (std::set<Constant>::iterator ite = i.collection().begin(); ite != i.collection().end(); ++ite)
-    if (*ite == e.first.value()) result = true;
+  // the collection is ordered by the values of its constants
+  bool result = i.collection().count(e.first) > 0;
 
   exprStack_.push(std::make_pair(Constant(result), e.second));
 }
@@ -320,4 +318,36 @@ void EvalVisitor::visitBitslice(const Bitslice& b) {
   exprStack_.push(std::make_pair(constant, false));
 }
 
+void EvalVisitor::visitReduction(const Reduction& r) {
+  stack_entry result;
+  for (unsigned i = 0; i < r.operands().size(); ++i) {
+    r.operands()[i]->visit(this);
+    stack_entry entry;
+    pop(entry);
+    if (i == 0) {
+      result = entry;
+      continue;
+    }
+
+    uint64_t value = result.first.value();
+    switch (r.kind()) {
+      case Reduction::SUM:
+        value += entry.first.value();
+        break;
+      case Reduction::AND:
+        value &= entry.first.value();
+        break;
+      case Reduction::OR:
+        value |= entry.first.value();
+        break;
+      case Reduction::XOR:
+        value ^= entry.first.value();
+        break;
+    }
+    result = std::make_pair(Constant(value, result.first.bitsize(), result.first.sign() || entry.first.sign()),
+                            result.second && entry.second);
+  }
+  exprStack_.push(result);
+}
+
 }  // end namespace crave
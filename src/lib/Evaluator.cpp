@@ -1,14 +1,150 @@
 #include "../crave/utils/Evaluator.hpp"
 
+#include <cassert>
+
 namespace crave {
 
+namespace {
+// evaluating many temporary expressions must not grow the cache without bound
+const unsigned max_cached_programs = 4096;
+
+// a constant, possibly extended to the width of the other operand by the FixWidthVisitor
+Constant const* constantOf(Node const& n) {
+  Node const* t = &n;
+  if (ExtendExpression const* e = dynamic_cast<ExtendExpression const*>(t)) t = e->child().get();
+  return dynamic_cast<Constant const*>(t);
+}
+
+bool fitsSigned(uint64_t value, unsigned width) { return width >= 64 || value < (1ULL << (width - 1)); }
+
+bool exactBoolean(Node const& n);
+
+// whether the 64 bit value of the evaluator is the value of the bits in the solver, sign extended if signed there
+bool exactNumber(Node const& n, unsigned* width, bool* sign) {
+  if (dynamic_cast<VariableExpr const*>(&n) || dynamic_cast<Constant const*>(&n)) {
+    Terminal const& t = static_cast<Terminal const&>(n);
+    if (t.bitsize() == 1 && t.sign()) return false;  // booleans are predicates in the solver
+    *width = t.bitsize();
+    *sign = t.sign();
+    return true;
+  }
+  if (ExtendExpression const* e = dynamic_cast<ExtendExpression const*>(&n)) {
+    if (!exactNumber(*e->child(), width, sign)) return false;
+    *width += e->value();
+    return true;
+  }
+  if (IfThenElse const* ite = dynamic_cast<IfThenElse const*>(&n)) {
+    unsigned w;
+    bool s;
+    return exactBoolean(*ite->a()) && exactNumber(*ite->b(), width, sign) && exactNumber(*ite->c(), &w, &s) &&
+           s == *sign;
+  }
+  BinaryExpression const* b = dynamic_cast<BinaryExpression const*>(&n);
+  unsigned rhs_width;
+  bool rhs_sign;
+  if (!b || !exactNumber(*b->lhs(), width, sign) || !exactNumber(*b->rhs(), &rhs_width, &rhs_sign)) return false;
+  // mixed signs extend the unsigned operand with zeros but the result is signed
+  if (dynamic_cast<AndOpr const*>(&n) || dynamic_cast<OrOpr const*>(&n) || dynamic_cast<XorOpr const*>(&n))
+    return *sign == rhs_sign;
+  // a positive divisor neither divides by zero nor overflows, signed divisions of mixed signs change the width
+  Constant const* divisor = constantOf(*b->rhs());
+  if (!divisor || rhs_sign || divisor->value() == 0) return false;
+  if (dynamic_cast<ModuloOpr const*>(&n)) return !*sign || fitsSigned(divisor->value(), *width);
+  if (dynamic_cast<DevideOpr const*>(&n)) return !*sign;
+  return false;
+}
+
+bool exactBoolean(Node const& n) {
+  if (Constant const* c = dynamic_cast<Constant const*>(&n)) return c->isBool();
+  if (VariableExpr const* v = dynamic_cast<VariableExpr const*>(&n)) return v->bitsize() == 1 && v->sign();
+  if (NotOpr const* u = dynamic_cast<NotOpr const*>(&n)) return exactBoolean(*u->child());
+  if (IfThenElse const* ite = dynamic_cast<IfThenElse const*>(&n))
+    return exactBoolean(*ite->a()) && exactBoolean(*ite->b()) && exactBoolean(*ite->c());
+  if (Inside const* in = dynamic_cast<Inside const*>(&n)) {
+    unsigned width;
+    bool sign;
+    if (!exactNumber(*in->child(), &width, &sign)) return false;
+    return in->collection().empty() || in->collection().begin()->sign() == sign;
+  }
+  BinaryExpression const* b = dynamic_cast<BinaryExpression const*>(&n);
+  if (!b) return false;
+  if (dynamic_cast<LogicalAndOpr const*>(&n) || dynamic_cast<LogicalOrOpr const*>(&n))
+    return exactBoolean(*b->lhs()) && exactBoolean(*b->rhs());
+
+  bool equality = dynamic_cast<EqualOpr const*>(&n) || dynamic_cast<NotEqualOpr const*>(&n);
+  bool ordering = dynamic_cast<LessOpr const*>(&n) || dynamic_cast<LessEqualOpr const*>(&n) ||
+                  dynamic_cast<GreaterOpr const*>(&n) || dynamic_cast<GreaterEqualOpr const*>(&n);
+  if (!equality && !ordering) return false;
+  if (equality && exactBoolean(*b->lhs()) && exactBoolean(*b->rhs())) return true;
+
+  unsigned lw, rw;
+  bool ls, rs;
+  if (!exactNumber(*b->lhs(), &lw, &ls) || !exactNumber(*b->rhs(), &rw, &rs)) return false;
+  // the evaluator compares unsigned
+  if (ordering) return !ls && !rs;
+  if (ls == rs) return true;
+  // the bits are compared, an unsigned constant has the same value as its sign extension if its top bit is 0
+  Constant const* c = constantOf(ls ? *b->rhs() : *b->lhs());
+  return c && fitsSigned(c->value(), lw);
+}
+}  // namespace
+
 template <>
-bool get_result(EvalVisitor const& v) {
-  return v.result().value() != 0;
+bool get_result(Constant const& c) {
+  return c.value() != 0;
 }
 
-void Evaluator::assign(unsigned id, Constant c) { assignments_[id] = c; }
+void Evaluator::assign(unsigned id, Constant c) {
+  std::pair<slot_map::iterator, bool> ins = slots_.insert(std::make_pair(id, slots_.size()));
+  if (ins.second) values_.resize(slots_.size());
+  values_[ins.first->second] = CompiledExpression::Value(c.value(), c.bitsize(), c.sign(), true);
+  if (ins.first->second < columns_.size()) columns_[ins.first->second].clear();
+}
 
-bool Evaluator::evaluate(expression const& expr) { return visitor_.evaluate(*boost::proto::value(expr)); }
+void Evaluator::assign_batch(unsigned id, unsigned width, bool sign, uint64_t const* values, unsigned lanes) {
+  assert(lanes > 0 && lanes <= CompiledExpression::batch_size);
+  assign(id, Constant(values[0], width, sign));
+  unsigned slot = slots_.at(id);
+  if (columns_.size() <= slot) columns_.resize(slot + 1);
+  columns_[slot].assign(values, values + lanes);
+}
+
+bool Evaluator::assigned_value(unsigned id, Constant* value) const {
+  slot_map::const_iterator ite = slots_.find(id);
+  if (ite == slots_.end() || !values_[ite->second].valid) return false;
+  CompiledExpression::Value const& v = values_[ite->second];
+  *value = Constant(v.value, v.width, v.sign);
+  return true;
+}
+
+CompiledExpression const& Evaluator::compile(NodePtr const& expr) {
+  program_map::iterator ite = programs_.find(expr.get());
+  if (ite != programs_.end()) return ite->second.second;
+
+  CompiledExpression program;
+  CompileVisitor compiler(&slots_);
+  compiler.compile(*expr, &program);
+  values_.resize(slots_.size());
+
+  if (programs_.size() >= max_cached_programs) programs_.clear();
+  return programs_.insert(std::make_pair(expr.get(), std::make_pair(expr, program))).first->second.second;
+}
+
+bool Evaluator::is_exact(Node const& constraint) { return exactBoolean(constraint); }
+
+bool Evaluator::evaluate(expression const& expr) {
+  return compile(boost::proto::value(expr)).run(&values_, &result_);
+}
+
+uint64_t Evaluator::evaluate_batch(expression const& expr, unsigned lanes) {
+  CompiledExpression const& program = compile(boost::proto::value(expr));
+  columns_.resize(values_.size());
+  column_ptrs_.resize(values_.size());
+  for (unsigned i = 0; i < columns_.size(); ++i) {
+    assert(columns_[i].empty() || columns_[i].size() >= lanes);
+    column_ptrs_[i] = columns_[i].empty() ? nullptr : columns_[i].data();
+  }
+  return program.runBatch(values_, column_ptrs_, lanes);
+}
 
 }
@@ -2,10 +2,35 @@
 
 #include "../crave/ir/visitor/FixWidthVisitor.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace crave {
 
+namespace {
+
+// the signedness the solver backend assigns to a number expression, if it can be determined
+bool knownSign(Node const& n, bool* sign) {
+  if (dynamic_cast<VariableExpr const*>(&n) || dynamic_cast<Constant const*>(&n)) {
+    *sign = static_cast<Terminal const&>(n).sign();
+    return true;
+  }
+  if (dynamic_cast<ExtendExpression const*>(&n) || dynamic_cast<NegOpr const*>(&n) ||
+      dynamic_cast<ComplementOpr const*>(&n))
+    return knownSign(*static_cast<UnaryExpression const&>(n).child(), sign);
+  if (dynamic_cast<PlusOpr const*>(&n) || dynamic_cast<MinusOpr const*>(&n) || dynamic_cast<MultipliesOpr const*>(&n) ||
+      dynamic_cast<AndOpr const*>(&n) || dynamic_cast<OrOpr const*>(&n) || dynamic_cast<XorOpr const*>(&n)) {
+    BinaryExpression const& b = static_cast<BinaryExpression const&>(n);
+    bool lhs, rhs;
+    if (!knownSign(*b.lhs(), &lhs) || !knownSign(*b.rhs(), &rhs)) return false;
+    *sign = lhs || rhs;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
 void FixWidthVisitor::pop(stack_entry& fst) {
   assert(exprStack_.size() >= 1);
   fst = exprStack_.top();
@@ -34,7 +59,10 @@ void FixWidthVisitor::evalBinExpr(BinaryExpression const& bin, stack_entry& fst,
                                   bool fixWidth = true) {
   visitBinaryExpr(bin);
   pop2(snd, fst);
-  if (!fixWidth) return;
+  if (fixWidth) extend(fst, snd);
+}
+
+void FixWidthVisitor::extend(stack_entry& fst, stack_entry& snd) {
   if (fst.second < snd.second) {
     unsigned int diff = snd.second - fst.second;
     fst.first = result_type(new ExtendExpression(fst.first.get(), diff));
@@ -46,6 +74,45 @@ void FixWidthVisitor::evalBinExpr(BinaryExpression const& bin, stack_entry& fst,
   }
 }
 
+/**
+ * Replaces the wider of both operands by a constant of the width of the other one, if it is a constant that lies in
+ * the range of the other operand. Equalities compare the bits of the extended operand, so the constant is read with
+ * the signedness of the operand. Orderings compare the values of both operands, as the backend extends mixed signed
+ * and unsigned operands by one bit.
+ */
+FixWidthVisitor::narrow_result FixWidthVisitor::narrowConstant(stack_entry& lhs, stack_entry& rhs, bool ordering) {
+  bool swapped = lhs.second > rhs.second;
+  stack_entry& operand = swapped ? rhs : lhs;
+  stack_entry& wide = swapped ? lhs : rhs;
+  Constant const* c = dynamic_cast<Constant const*>(wide.first.get());
+  bool sign;
+  // extended booleans are sign extended by the backend, leave them alone
+  if (!c || operand.second >= wide.second || operand.second < 2 || !knownSign(*operand.first, &sign))
+    return KEEP_WIDTH;
+
+  unsigned width = wide.second;
+  uint64_t mask = width < 64 ? (1ULL << width) - 1 : ~0ULL;
+  uint64_t value = c->value() & mask;
+  bool negative = (ordering ? c->sign() : sign) && ((value >> (width - 1)) & 1);
+  if (negative) value |= ~mask;
+
+  unsigned narrow = operand.second;
+  bool below, above;
+  if (negative) {
+    below = !sign || static_cast<int64_t>(value) < -static_cast<int64_t>(1ULL << (narrow - 1));
+    above = false;
+  } else {
+    below = false;
+    above = value > (sign ? (1ULL << (narrow - 1)) - 1 : (1ULL << narrow) - 1);
+  }
+  if (below) return swapped ? ALWAYS_LESS : ALWAYS_GREATER;
+  if (above) return swapped ? ALWAYS_GREATER : ALWAYS_LESS;
+
+  wide.first = result_type(new Constant(value, narrow, sign));
+  wide.second = narrow;
+  return NARROWED;
+}
+
 void FixWidthVisitor::evalTernExpr(TernaryExpression const& tern, stack_entry& fst, stack_entry& snd,
                                    stack_entry& trd) {
   visitTernaryExpr(tern);
@@ -95,6 +162,26 @@ void FixWidthVisitor::visitBooleanResultBinExpr(const T& object) {
   exprStack_.push(std::make_pair(new T(lhs.first, rhs.first), 1));
 }
 
+template <typename T>
+void FixWidthVisitor::visitComparison(const T& object, bool ordering, bool if_less, bool if_greater) {
+  stack_entry lhs, rhs;
+  evalBinExpr(object, lhs, rhs, false);
+  switch (narrowConstant(lhs, rhs, ordering)) {
+    case ALWAYS_LESS:
+      exprStack_.push(std::make_pair(new Constant(if_less), 1));
+      return;
+    case ALWAYS_GREATER:
+      exprStack_.push(std::make_pair(new Constant(if_greater), 1));
+      return;
+    case KEEP_WIDTH:
+      extend(lhs, rhs);
+      break;
+    case NARROWED:
+      break;
+  }
+  exprStack_.push(std::make_pair(new T(lhs.first, rhs.first), 1));
+}
+
 void FixWidthVisitor::visitPlaceholder(const Placeholder& pl) {
   exprStack_.push(std::make_pair(new Placeholder(pl), placeholder_bitsize()));
 }
@@ -145,17 +232,17 @@ void FixWidthVisitor::visitLogicalOrOpr(const LogicalOrOpr& lo) { visitBooleanRe
 
 void FixWidthVisitor::visitXorOpr(const XorOpr& x) { visitNumberResultBinExpr(x); }
 
-void FixWidthVisitor::visitEqualOpr(const EqualOpr& eq) { visitBooleanResultBinExpr(eq); }
+void FixWidthVisitor::visitEqualOpr(const EqualOpr& eq) { visitComparison(eq, false, false, false); }
 
-void FixWidthVisitor::visitNotEqualOpr(const NotEqualOpr& neq) { visitBooleanResultBinExpr(neq); }
+void FixWidthVisitor::visitNotEqualOpr(const NotEqualOpr& neq) { visitComparison(neq, false, true, true); }
 
-void FixWidthVisitor::visitLessOpr(const LessOpr& l) { visitBooleanResultBinExpr(l); }
+void FixWidthVisitor::visitLessOpr(const LessOpr& l) { visitComparison(l, true, true, false); }
 
-void FixWidthVisitor::visitLessEqualOpr(const LessEqualOpr& le) { visitBooleanResultBinExpr(le); }
+void FixWidthVisitor::visitLessEqualOpr(const LessEqualOpr& le) { visitComparison(le, true, true, false); }
 
-void FixWidthVisitor::visitGreaterOpr(const GreaterOpr& g) { visitBooleanResultBinExpr(g); }
+void FixWidthVisitor::visitGreaterOpr(const GreaterOpr& g) { visitComparison(g, true, false, true); }
 
-void FixWidthVisitor::visitGreaterEqualOpr(const GreaterEqualOpr& ge) { visitBooleanResultBinExpr(ge); }
+void FixWidthVisitor::visitGreaterEqualOpr(const GreaterEqualOpr& ge) { visitComparison(ge, true, false, true); }
 
 void FixWidthVisitor::visitPlusOpr(const PlusOpr& p) { visitNumberResultBinExpr(p); }
 
@@ -201,4 +288,27 @@ void FixWidthVisitor::visitBitslice(const Bitslice& b) {
   exprStack_.push(std::make_pair(new Bitslice(e.first, b.r(), b.l()), b.r() - b.l() + 1));
 }
 
+void FixWidthVisitor::visitReduction(const Reduction& r) {
+  std::vector<stack_entry> entries(r.operands().size());
+  int width = 0;
+  for (unsigned i = 0; i < entries.size(); ++i) {
+    r.operands()[i]->visit(this);
+    pop(entries[i]);
+    width = std::max(width, entries[i].second);
+  }
+  if (r.kind() == Reduction::SUM) {
+    // add the carry bits of the sum of all operands
+    for (unsigned n = entries.size() - 1; n > 0 && width < 64; n >>= 1) ++width;
+  }
+
+  std::vector<result_type> operands;
+  for(stack_entry const& e : entries) {
+    if (e.second < width)
+      operands.push_back(new ExtendExpression(e.first, width - e.second));
+    else
+      operands.push_back(e.first);
+  }
+  exprStack_.push(std::make_pair(new Reduction(r.kind(), operands), width));
+}
+
 }  // end namespace crave
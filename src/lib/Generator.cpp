@@ -36,11 +36,9 @@ void Generator::reset() {
 void Generator::rebuild(bool selfInclude) {
   if (selfInclude) merge(*this);
   constr_pttn_.partition();
-  // currently, every hard/soft/cover constraint is considered for
-  // partitioning, this is suboptimal.
   var_gen_->reset(constr_pttn_.getPartitions());
   vec_gen_.reset(constr_pttn_.getVectorConstraints());
-  var_cov_gen_.reset(constr_pttn_.getPartitions());
+  var_cov_gen_.reset(constr_pttn_.getCoveragePartitions());
 }
 
 bool Generator::next() {
@@ -48,15 +46,23 @@ bool Generator::next() {
     reset();
     rebuild(true);
   }
+  if (lazy_ && to_be_generated_vec_ids_.empty()) {
+    var_gen_->invalidate();
+    return var_gen_->analyseContradiction().empty();
+  }
+  var_gen_->invalidate(false);
   return var_gen_->solve() && vec_gen_.solve(*var_gen_, to_be_generated_vec_ids_);
 }
 
+bool Generator::materialize() { return var_gen_->materialize(); }
+
 bool Generator::nextCov() {
   if (constr_mng_.isChanged()) {
     reset();
     rebuild(true);
   }
   if (!covered_) {
+    var_gen_->invalidate(false);
     if (var_cov_gen_.solve() && vec_gen_.solve(var_cov_gen_, to_be_generated_vec_ids_))
       return true;
     else
@@ -69,7 +75,7 @@ bool Generator::isCovered() { return covered_; }
 
 void Generator::resetCoverage() {
   covered_ = false;
-  var_cov_gen_.reset(constr_pttn_.getPartitions());
+  var_cov_gen_.reset(constr_pttn_.getCoveragePartitions());
 }
 
 std::ostream& Generator::printDotGraph(std::ostream& os, bool root) {
@@ -4,6 +4,36 @@
 
 namespace crave {
 
+namespace {
+// evaluates a subscript to placeholder_coefficient * placeholder + offset
+bool affineSubscript(Node const& n, int* coefficient, int* offset) {
+  if (dynamic_cast<Placeholder const*>(&n)) {
+    *coefficient = 1;
+    *offset = 0;
+    return true;
+  }
+  if (Constant const* c = dynamic_cast<Constant const*>(&n)) {
+    int64_t value = c->value();
+    if (c->sign() && c->bitsize() < 64 && (c->value() >> (c->bitsize() - 1)) & 1) value -= (int64_t)1 << c->bitsize();
+    *coefficient = 0;
+    *offset = value;
+    return true;
+  }
+  if (ExtendExpression const* e = dynamic_cast<ExtendExpression const*>(&n)) {
+    return affineSubscript(*e->child(), coefficient, offset);
+  }
+  BinaryExpression const* b = dynamic_cast<PlusOpr const*>(&n);
+  if (!b) b = dynamic_cast<MinusOpr const*>(&n);
+  if (!b) return false;
+  int lc, lo, rc, ro;
+  if (!affineSubscript(*b->lhs(), &lc, &lo) || !affineSubscript(*b->rhs(), &rc, &ro)) return false;
+  bool plus = dynamic_cast<PlusOpr const*>(&n) != 0;
+  *coefficient = plus ? lc + rc : lc - rc;
+  *offset = plus ? lo + ro : lo - ro;
+  return true;
+}
+}  // namespace
+
 void GetSupportSetVisitor::visitNode(const Node&) {}
 
 void GetSupportSetVisitor::visitTerminal(const Terminal&) {}
@@ -79,7 +109,14 @@ void GetSupportSetVisitor::visitShiftLeftOpr(const ShiftLeftOpr& shl) { visitBin
 
 void GetSupportSetVisitor::visitShiftRightOpr(const ShiftRightOpr& shr) { visitBinaryExpr(shr); }
 
-void GetSupportSetVisitor::visitVectorAccess(const VectorAccess& va) { visitBinaryExpr(va); }
+void GetSupportSetVisitor::visitVectorAccess(const VectorAccess& va) {
+  int coefficient, offset;
+  if (affineSubscript(*va.rhs(), &coefficient, &offset) && coefficient == 1)
+    index_offsets.insert(offset);
+  else
+    irregular_index = true;
+  visitBinaryExpr(va);
+}
 
 void GetSupportSetVisitor::visitForEach(const ForEach& fe) { visitBinaryExpr(fe); }
 
@@ -89,4 +126,8 @@ void GetSupportSetVisitor::visitIfThenElse(const IfThenElse& ite) { visitTernary
 
 void GetSupportSetVisitor::visitBitslice(const Bitslice& b) { visitUnaryExpr(b); }
 
+void GetSupportSetVisitor::visitReduction(const Reduction& r) {
+  for(NodePtr const& n : r.operands()) n->visit(this);
+}
+
 }  // end namespace crave
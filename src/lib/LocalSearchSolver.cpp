@@ -0,0 +1,432 @@
+#include "../crave/backend/LocalSearchSolver.hpp"
+#include "../crave/RandomSeedManager.hpp"
+#include "../crave/utils/Logging.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+
+namespace crave {
+
+extern RandomSeedManager rng;
+extern std::function<unsigned(unsigned)> random_unsigned;
+
+unsigned LocalSearchSolver::max_steps = 1000;
+
+unsigned LocalSearchSolver::restart_steps = 250;
+
+unsigned LocalSearchSolver::noise = 10;
+
+unsigned long LocalSearchSolver::solved_by_search = 0;
+
+namespace {
+
+// candidates of a move with one bit flipped and near constants, the remaining ones are random values
+const unsigned max_flips = 32;
+const unsigned constant_candidates = 16;
+
+// keeps the bits of the width, signed values are sign extended like the ones of Context and AssignResult
+Constant toConstant(uint64_t bits, unsigned width, bool sign) {
+  if (width < 64) {
+    bits &= (1ULL << width) - 1;
+    if (sign && width > 1 && ((bits >> (width - 1)) & 1)) bits |= ~((1ULL << width) - 1);
+  }
+  return Constant(bits, width, sign);
+}
+
+std::string toBits(uint64_t value, unsigned width) {
+  std::string bits(width, '0');
+  for (unsigned i = 0; i < width && i < 64; ++i) {
+    if ((value >> i) & 1) bits[width - 1 - i] = '1';
+  }
+  return bits;
+}
+
+// a value of a variable, e.g. the random value of a suggestion or the value of a read reference
+bool valueOf(Node const& n, int* id, Constant* value) {
+  EqualOpr const* eq = dynamic_cast<EqualOpr const*>(&n);
+  VariableExpr const* var = eq ? dynamic_cast<VariableExpr const*>(eq->lhs().get()) : nullptr;
+  Constant const* c = eq ? dynamic_cast<Constant const*>(eq->rhs().get()) : nullptr;
+  if (!var || !c) return false;
+  *id = var->id();
+  *value = *c;
+  return true;
+}
+
+template <typename T>
+bool copyAs(Node const& n, NodePtr* copy) {
+  T const* t = dynamic_cast<T const*>(&n);
+  if (t) *copy = NodePtr(new T(*t));
+  return t != nullptr;
+}
+
+// the solvers may get nodes on the stack, so a kept constraint is a copy of its top node sharing the children
+NodePtr copyConstraint(Node const& n) {
+  NodePtr copy;
+  if (copyAs<EqualOpr>(n, &copy) || copyAs<NotEqualOpr>(n, &copy) || copyAs<LessOpr>(n, &copy) ||
+      copyAs<LessEqualOpr>(n, &copy) || copyAs<GreaterOpr>(n, &copy) || copyAs<GreaterEqualOpr>(n, &copy) ||
+      copyAs<LogicalAndOpr>(n, &copy) || copyAs<LogicalOrOpr>(n, &copy) || copyAs<NotOpr>(n, &copy) ||
+      copyAs<IfThenElse>(n, &copy) || copyAs<Inside>(n, &copy) || copyAs<VariableExpr>(n, &copy) ||
+      copyAs<Constant>(n, &copy))
+    return copy;
+  return NodePtr();
+}
+
+expression constraintExpr(NodePtr const& c) {
+  return boost::proto::make_expr<boost::proto::tag::terminal, Constraint_Domain>(c);
+}
+
+}  // namespace
+
+LocalSearchSolver::LocalSearchSolver(metaSMTVisitor* complete)
+    : metaSMTVisitor(),
+      complete_(complete),
+      hards_(),
+      hard_supports_(),
+      hard_constants_(),
+      assumptions_(),
+      suggestions_(),
+      variables_(),
+      support_(nullptr),
+      constants_(nullptr),
+      searchable_(true),
+      fallback_(false),
+      searched_(false),
+      solved_(0),
+      failed_(0),
+      model_(),
+      evaluator_() {}
+
+void LocalSearchSolver::makeAssertion(Node const& expr) {
+  complete_->makeAssertion(expr);
+  if (!searchable_) return;
+  NodePtr copy = Evaluator::is_exact(expr) ? copyConstraint(expr) : NodePtr();
+  if (!copy) {
+    searchable_ = false;
+    return;
+  }
+  hards_.push_back(copy);
+  hard_supports_.push_back(std::vector<int>());
+  hard_constants_.push_back(std::vector<uint64_t>());
+  collect(*copy, &hard_supports_.back(), &hard_constants_.back());
+}
+
+void LocalSearchSolver::makeSoftAssertion(Node const& expr) {
+  complete_->makeSoftAssertion(expr);
+  searchable_ = false;
+}
+
+void LocalSearchSolver::makeSuggestion(Node const& expr) {
+  int id;
+  Constant value;
+  if (searchable_ && !fallback_ && valueOf(expr, &id, &value)) {
+    suggestions_.push_back(copyConstraint(expr));
+    return;
+  }
+  fallBack();
+  complete_->makeSuggestion(expr);
+}
+
+void LocalSearchSolver::makeAssumption(Node const& expr) {
+  NodePtr copy = searchable_ && !fallback_ && Evaluator::is_exact(expr) ? copyConstraint(expr) : NodePtr();
+  if (copy) {
+    assumptions_.push_back(copy);
+    return;
+  }
+  fallBack();
+  complete_->makeAssumption(expr);
+}
+
+std::vector<unsigned int> LocalSearchSolver::analyseSofts() { return complete_->analyseSofts(); }
+
+std::vector<std::vector<unsigned int> > LocalSearchSolver::analyseContradiction(
+    std::map<unsigned int, NodePtr> const& s) {
+  return complete_->analyseContradiction(s);
+}
+
+bool LocalSearchSolver::solve(bool ignoreSofts) {
+  searched_ = false;
+  if (searchable_ && !fallback_) {
+    if (search()) {
+      ++solved_;
+      ++solved_by_search;
+      searched_ = true;
+      assumptions_.clear();
+      suggestions_.clear();
+      return true;
+    }
+    if (++failed_ > solved_) {
+      LOG(INFO) << "Stop local search after " << failed_ << " failed search(es)";
+      searchable_ = false;
+    }
+  }
+  fallBack();
+  fallback_ = false;
+  return complete_->solve(ignoreSofts);
+}
+
+void LocalSearchSolver::fallBack() {
+  if (fallback_) return;
+  fallback_ = true;
+  for (NodePtr const& n : assumptions_) complete_->makeAssumption(*n);
+  for (NodePtr const& n : suggestions_) complete_->makeSuggestion(*n);
+  assumptions_.clear();
+  suggestions_.clear();
+}
+
+bool LocalSearchSolver::read(Node const& var, AssignResult& assign) {
+  if (!searched_) return complete_->read(var, assign);
+  std::string bits;
+  if (!read(var, bits)) return false;
+  assign.set_value(bits);
+  return true;
+}
+
+bool LocalSearchSolver::read(Node const& var, std::string& str) {
+  if (!searched_) return complete_->read(var, str);
+  std::map<int, Constant>::const_iterator ite = model_.find(static_cast<VariableExpr const&>(var).id());
+  if (ite == model_.end()) return false;
+  str = toBits(ite->second.value(), ite->second.bitsize());
+  return true;
+}
+
+bool LocalSearchSolver::readVector(const std::vector<VariablePtr>& vec, __rand_vec_base* rand_vec) {
+  if (!searched_) return complete_->readVector(vec, rand_vec);
+  std::vector<std::string> sv(vec.size());
+  for (unsigned i = 0; i < vec.size(); ++i) {
+    if (!read(*vec[i], sv[i])) return false;
+  }
+  rand_vec->set_values(sv);
+  return true;
+}
+
+void LocalSearchSolver::collect(Node const& constraint, std::vector<int>* support, std::vector<uint64_t>* constants) {
+  std::set<int> ids;
+  std::set<uint64_t> values;
+  support_ = &ids;
+  constants_ = &values;
+  constraint.visit(this);
+  support_ = nullptr;
+  constants_ = nullptr;
+  support->assign(ids.begin(), ids.end());
+  constants->assign(values.begin(), values.end());
+}
+
+bool LocalSearchSolver::search() {
+  std::vector<NodePtr> constraints(hards_);
+  std::vector<std::vector<int> > supports(hard_supports_);
+  std::vector<std::vector<uint64_t> > constants(hard_constants_);
+  std::map<int, Constant> fixed;
+  for (NodePtr const& a : assumptions_) {
+    constraints.push_back(a);
+    supports.push_back(std::vector<int>());
+    constants.push_back(std::vector<uint64_t>());
+    collect(*a, &supports.back(), &constants.back());
+    int id;
+    Constant value;
+    if (valueOf(*a, &id, &value)) fixed[id] = value;
+  }
+  std::map<int, Constant> seeds;
+  for (NodePtr const& s : suggestions_) {
+    int id;
+    Constant value;
+    if (valueOf(*s, &id, &value)) seeds[id] = value;
+  }
+
+  std::map<int, std::vector<unsigned> > occurs;
+  for (unsigned i = 0; i < constraints.size(); ++i) {
+    for (int id : supports[i]) occurs[id].push_back(i);
+  }
+  std::vector<int> free;
+  for (std::pair<int const, std::vector<unsigned> > const& o : occurs) {
+    std::pair<unsigned, bool> const& var = variables_.at(o.first);
+    if (fixed.count(o.first)) {
+      evaluator_.assign(static_cast<unsigned>(o.first),
+                        toConstant(fixed.at(o.first).value(), var.first, var.second));
+    } else {
+      free.push_back(o.first);
+    }
+  }
+
+  std::uniform_int_distribution<uint64_t> random_bits;
+  std::vector<unsigned> violated;
+  std::vector<int> movable;
+  for (unsigned step = 0; step < max_steps; ++step) {
+    if (step % restart_steps == 0) {
+      for (int id : free) {
+        std::pair<unsigned, bool> const& var = variables_.at(id);
+        uint64_t bits = step == 0 && seeds.count(id) ? seeds.at(id).value() : random_bits(*rng.get());
+        evaluator_.assign(static_cast<unsigned>(id), toConstant(bits, var.first, var.second));
+      }
+    }
+
+    violated.clear();
+    for (unsigned i = 0; i < constraints.size(); ++i) {
+      if (!evaluator_.evaluate(constraintExpr(constraints[i])) || !evaluator_.result<bool>()) violated.push_back(i);
+    }
+    if (violated.empty()) {
+      model_.clear();
+      for (std::pair<int const, std::vector<unsigned> > const& o : occurs) {
+        evaluator_.assigned_value(static_cast<unsigned>(o.first), &model_[o.first]);
+      }
+      LOG(INFO) << "Local search found a solution after " << step << " step(s)";
+      return true;
+    }
+
+    unsigned c = violated[random_unsigned(violated.size())];
+    movable.clear();
+    for (int id : supports[c]) {
+      if (!fixed.count(id)) movable.push_back(id);
+    }
+    if (movable.empty()) return false;  // the assumptions violate the constraint
+    int id = movable[random_unsigned(movable.size())];
+    move(id, constraints, occurs.at(id), constants[c]);
+  }
+  return false;
+}
+
+void LocalSearchSolver::move(int id, std::vector<NodePtr> const& constraints, std::vector<unsigned> const& occurs,
+                             std::vector<uint64_t> const& constants) {
+  unsigned const lanes = CompiledExpression::batch_size;
+  unsigned width = variables_.at(id).first;
+  bool sign = variables_.at(id).second;
+  Constant current;
+  evaluator_.assigned_value(static_cast<unsigned>(id), &current);
+
+  // flips of all bits of narrow variables, of random bits otherwise
+  std::uniform_int_distribution<uint64_t> random_bits;
+  uint64_t candidates[lanes];
+  unsigned flips = std::min(width, max_flips);
+  unsigned neighbors = constants.empty() ? 0 : constant_candidates;
+  for (unsigned k = 0; k < lanes; ++k) {
+    uint64_t bits;
+    if (k < flips) {
+      bits = current.value() ^ (1ULL << (width > max_flips ? random_unsigned(width) : k));
+    } else if (k < flips + neighbors) {
+      // a bound of an ordering or range is often the only value that satisfies it after one move
+      bits = constants[random_unsigned(constants.size())] + random_unsigned(3) - 1;
+    } else {
+      bits = random_bits(*rng.get());
+    }
+    candidates[k] = toConstant(bits, width, sign).value();
+  }
+
+  unsigned pick;
+  if (random_unsigned(100) < noise) {
+    pick = random_unsigned(lanes);
+  } else {
+    unsigned score[lanes] = {0};
+    evaluator_.assign_batch(static_cast<unsigned>(id), width, sign, candidates, lanes);
+    for (unsigned i : occurs) {
+      uint64_t satisfied = evaluator_.evaluate_batch(constraintExpr(constraints[i]), lanes);
+      for (unsigned k = 0; k < lanes; ++k) score[k] += (satisfied >> k) & 1;
+    }
+    unsigned best = *std::max_element(score, score + lanes);
+    std::vector<unsigned> ties;
+    for (unsigned k = 0; k < lanes; ++k) {
+      if (score[k] == best) ties.push_back(k);
+    }
+    pick = ties[random_unsigned(ties.size())];
+  }
+  evaluator_.assign(static_cast<unsigned>(id), Constant(candidates[pick], width, sign));
+}
+
+void LocalSearchSolver::visitNode(Node const&) {}
+
+void LocalSearchSolver::visitTerminal(Terminal const&) {}
+
+void LocalSearchSolver::visitUnaryExpr(UnaryExpression const& u) { u.child()->visit(this); }
+
+void LocalSearchSolver::visitUnaryOpr(UnaryOperator const&) {}
+
+void LocalSearchSolver::visitBinaryExpr(BinaryExpression const& b) {
+  b.lhs()->visit(this);
+  b.rhs()->visit(this);
+}
+
+void LocalSearchSolver::visitBinaryOpr(BinaryOperator const&) {}
+
+void LocalSearchSolver::visitTernaryExpr(TernaryExpression const& t) {
+  t.a()->visit(this);
+  t.b()->visit(this);
+  t.c()->visit(this);
+}
+
+void LocalSearchSolver::visitPlaceholder(Placeholder const&) {}
+
+void LocalSearchSolver::visitVariableExpr(VariableExpr const& v) {
+  support_->insert(v.id());
+  variables_[v.id()] = std::make_pair(v.bitsize(), v.sign());
+}
+
+void LocalSearchSolver::visitConstant(Constant const& c) { constants_->insert(c.value()); }
+
+void LocalSearchSolver::visitVectorExpr(VectorExpr const&) {}
+
+void LocalSearchSolver::visitNotOpr(NotOpr const& n) { visitUnaryExpr(n); }
+
+void LocalSearchSolver::visitNegOpr(NegOpr const& n) { visitUnaryExpr(n); }
+
+void LocalSearchSolver::visitComplementOpr(ComplementOpr const& c) { visitUnaryExpr(c); }
+
+void LocalSearchSolver::visitInside(Inside const& i) {
+  for (Inside::range_list::value_type const& range : i.ranges()) {
+    constants_->insert(range.first.value());
+    constants_->insert(range.second.value());
+  }
+  visitUnaryExpr(i);
+}
+
+void LocalSearchSolver::visitExtendExpr(ExtendExpression const& e) { visitUnaryExpr(e); }
+
+void LocalSearchSolver::visitAndOpr(AndOpr const& a) { visitBinaryExpr(a); }
+
+void LocalSearchSolver::visitOrOpr(OrOpr const& o) { visitBinaryExpr(o); }
+
+void LocalSearchSolver::visitLogicalAndOpr(LogicalAndOpr const& la) { visitBinaryExpr(la); }
+
+void LocalSearchSolver::visitLogicalOrOpr(LogicalOrOpr const& lo) { visitBinaryExpr(lo); }
+
+void LocalSearchSolver::visitXorOpr(XorOpr const& x) { visitBinaryExpr(x); }
+
+void LocalSearchSolver::visitEqualOpr(EqualOpr const& eq) { visitBinaryExpr(eq); }
+
+void LocalSearchSolver::visitNotEqualOpr(NotEqualOpr const& neq) { visitBinaryExpr(neq); }
+
+void LocalSearchSolver::visitLessOpr(LessOpr const& l) { visitBinaryExpr(l); }
+
+void LocalSearchSolver::visitLessEqualOpr(LessEqualOpr const& le) { visitBinaryExpr(le); }
+
+void LocalSearchSolver::visitGreaterOpr(GreaterOpr const& g) { visitBinaryExpr(g); }
+
+void LocalSearchSolver::visitGreaterEqualOpr(GreaterEqualOpr const& ge) { visitBinaryExpr(ge); }
+
+void LocalSearchSolver::visitPlusOpr(PlusOpr const& p) { visitBinaryExpr(p); }
+
+void LocalSearchSolver::visitMinusOpr(MinusOpr const& m) { visitBinaryExpr(m); }
+
+void LocalSearchSolver::visitMultipliesOpr(MultipliesOpr const& m) { visitBinaryExpr(m); }
+
+void LocalSearchSolver::visitDevideOpr(DevideOpr const& d) { visitBinaryExpr(d); }
+
+void LocalSearchSolver::visitModuloOpr(ModuloOpr const& m) { visitBinaryExpr(m); }
+
+void LocalSearchSolver::visitShiftLeftOpr(ShiftLeftOpr const& shl) { visitBinaryExpr(shl); }
+
+void LocalSearchSolver::visitShiftRightOpr(ShiftRightOpr const& shr) { visitBinaryExpr(shr); }
+
+void LocalSearchSolver::visitVectorAccess(VectorAccess const& va) { visitBinaryExpr(va); }
+
+void LocalSearchSolver::visitIfThenElse(IfThenElse const& ite) { visitTernaryExpr(ite); }
+
+void LocalSearchSolver::visitForEach(ForEach const& fe) { visitBinaryExpr(fe); }
+
+void LocalSearchSolver::visitUnique(Unique const& u) { visitUnaryExpr(u); }
+
+void LocalSearchSolver::visitBitslice(Bitslice const& b) { visitUnaryExpr(b); }
+
+void LocalSearchSolver::visitReduction(Reduction const& r) {
+  for (NodePtr const& n : r.operands()) n->visit(this);
+}
+
+}  // namespace crave
@@ -0,0 +1,123 @@
+#include "../crave/backend/RejectionSampler.hpp"
+#include "../crave/RandomSeedManager.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <random>
+#include <string>
+
+namespace crave {
+
+extern RandomSeedManager rng;
+
+namespace {
+
+// keeps the bits of the width, signed values are sign extended like the ones of Context and AssignResult
+Constant toConstant(uint64_t bits, unsigned width, bool sign) {
+  if (width < 64) {
+    bits &= (1ULL << width) - 1;
+    if (sign && width > 1 && ((bits >> (width - 1)) & 1)) bits |= ~((1ULL << width) - 1);
+  }
+  return Constant(bits, width, sign);
+}
+
+std::string toBits(uint64_t value, unsigned width) {
+  std::string bits(width, '0');
+  for (unsigned i = 0; i < width && i < 64; ++i) {
+    if ((value >> i) & 1) bits[width - 1 - i] = '1';
+  }
+  return bits;
+}
+
+}  // namespace
+
+bool RejectionSampler::applicable(VariableContainer const& vcon, ConstraintPartition const& cp) {
+  if (vcon.variables.empty() || !vcon.dist_references.empty()) return false;
+  for (ConstraintPtr c : cp) {
+    if (c->isCover()) continue;
+    if (c->isSoft() || !Evaluator::is_exact(*c->expr())) return false;
+  }
+  return true;
+}
+
+RejectionSampler::RejectionSampler(VariableContainer const& vcon, ConstraintPartition const& cp)
+    : columns_(), constraints_(), evaluator_(), tried_(0), accepted_(0) {
+  std::map<int, AssignResult*> write_refs;
+  for (VariableContainer::WriteRefPair const& pair : vcon.write_references) write_refs[pair.first] = pair.second.get();
+  std::map<int, ReferenceExpression*> read_refs;
+  for (VariableContainer::ReadRefPair const& pair : vcon.read_references) read_refs[pair.first] = pair.second.get();
+
+  for (std::pair<int const, NodePtr> const& v : vcon.variables) {
+    Terminal const& t = static_cast<Terminal const&>(*v.second);
+    Column col = {v.first, t.bitsize(), t.sign(), nullptr, nullptr};
+    if (write_refs.count(v.first)) col.write_ref = write_refs.at(v.first);
+    if (read_refs.count(v.first)) col.read_ref = read_refs.at(v.first);
+    columns_.push_back(col);
+  }
+  for (ConstraintPtr c : cp) {
+    if (!c->isSoft() && !c->isCover()) constraints_.push_back(c->expr());
+  }
+}
+
+bool RejectionSampler::sample(unsigned candidates, std::set<int> const& frozen, std::map<int, Constant>* values) {
+  std::vector<bool> fixed(columns_.size());
+  for (unsigned i = 0; i < columns_.size(); ++i) {
+    Column const& col = columns_[i];
+    if (col.read_ref) {
+      // read references are always of the form var == value
+      NodePtr e = col.read_ref->expr();
+      evaluator_.assign(static_cast<unsigned>(col.id), *static_cast<Constant const*>(
+                                                           static_cast<EqualOpr const&>(*e).rhs().get()));
+      fixed[i] = true;
+    } else if (col.write_ref && frozen.count(col.id)) {
+      evaluator_.assign(static_cast<unsigned>(col.id), col.write_ref->value_as_constant());
+      fixed[i] = true;
+    }
+  }
+
+  // the candidates are checked in batches, a column of random values per free variable
+  unsigned const batch_size = CompiledExpression::batch_size;
+  std::vector<uint64_t> lanes(columns_.size() * batch_size);
+  std::uniform_int_distribution<uint64_t> random_bits;
+  for (unsigned done = 0; done < candidates; done += batch_size) {
+    unsigned num_lanes = std::min(candidates - done, batch_size);
+    for (unsigned i = 0; i < columns_.size(); ++i) {
+      if (fixed[i]) continue;
+      Column const& col = columns_[i];
+      uint64_t* column = &lanes[i * batch_size];
+      for (unsigned k = 0; k < num_lanes; ++k) {
+        column[k] = toConstant(random_bits(*rng.get()), col.width, col.sign).value();
+      }
+      evaluator_.assign_batch(static_cast<unsigned>(col.id), col.width, col.sign, column, num_lanes);
+    }
+
+    uint64_t satisfied = num_lanes == batch_size ? ~0ULL : (1ULL << num_lanes) - 1;
+    for (NodePtr const& c : constraints_) {
+      satisfied &= evaluator_.evaluate_batch(
+          boost::proto::make_expr<boost::proto::tag::terminal, Constraint_Domain>(c), num_lanes);
+      if (!satisfied) break;
+    }
+    tried_ += num_lanes;
+    if (!satisfied) continue;
+    accepted_ += std::bitset<64>(satisfied).count();
+
+    // the candidates are independent, so the first satisfying one is as random as any other
+    unsigned lane = 0;
+    while (!((satisfied >> lane) & 1)) ++lane;
+    for (unsigned i = 0; i < columns_.size(); ++i) {
+      Column const& col = columns_[i];
+      Constant value;
+      if (fixed[i]) {
+        evaluator_.assigned_value(static_cast<unsigned>(col.id), &value);
+      } else {
+        value = Constant(lanes[i * batch_size + lane], col.width, col.sign);
+        if (col.write_ref) col.write_ref->set_value(toBits(value.value(), col.width));
+      }
+      (*values)[col.id] = value;
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace crave
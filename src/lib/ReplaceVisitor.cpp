@@ -73,7 +73,10 @@ void ReplaceVisitor::visitPlaceholder(Placeholder const& p) {
     // v already exists
     aux_stack_.push(ite->second);
   } else {
-    aux_stack_.push(new Constant(vec_idx_, placeholder_bitsize(), false));
+    if (idx_var_)
+      aux_stack_.push(idx_var_);
+    else
+      aux_stack_.push(new Constant(vec_idx_, placeholder_bitsize(), false));
     terminals_.insert(std::make_pair(p.id(), aux_stack_.top()));
   }
   updateResult();
@@ -354,6 +357,31 @@ void ReplaceVisitor::visitBitslice(Bitslice const& b) {
   subscript_stack_.push(!idx);
 }
 
+void ReplaceVisitor::visitReduction(Reduction const& r) {
+  std::vector<NodePtr> operands;
+  int value = 0;
+  for (unsigned i = 0; i < r.operands().size(); ++i) {
+    r.operands()[i]->visit(this);
+    operands.push_back(aux_stack_.top());
+    aux_stack_.pop();
+    int idx = subscript_stack_.top();
+    subscript_stack_.pop();
+    if (i == 0)
+      value = idx;
+    else if (r.kind() == Reduction::SUM)
+      value += idx;
+    else if (r.kind() == Reduction::AND)
+      value &= idx;
+    else if (r.kind() == Reduction::OR)
+      value |= idx;
+    else
+      value ^= idx;
+  }
+  aux_stack_.push(new Reduction(r.kind(), operands));
+  updateResult();
+  subscript_stack_.push(value);
+}
+
 void ReplaceVisitor::updateResult() { result_ = aux_stack_.top(); }
 
 void ReplaceVisitor::reset() {
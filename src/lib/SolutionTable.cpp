@@ -0,0 +1,134 @@
+#include "../crave/backend/SolutionTable.hpp"
+#include "../crave/backend/FactoryMetaSMT.hpp"
+#include "../crave/utils/Logging.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace crave {
+
+extern std::function<unsigned(unsigned)> random_unsigned;
+
+namespace {
+
+uint64_t mask(uint64_t value, unsigned width) { return width < 64 ? value & ((1ULL << width) - 1) : value; }
+
+// signed values are sign extended like the ones of Context and AssignResult
+Constant toConstant(uint64_t bits, unsigned width, bool sign) {
+  if (sign && width > 1 && width < 64 && ((bits >> (width - 1)) & 1)) bits |= ~((1ULL << width) - 1);
+  return Constant(bits, width, sign);
+}
+
+// unassigned bits, if the backend reports any, are taken as 0
+uint64_t fromBits(std::string const& bits) {
+  uint64_t value = 0;
+  for (char c : bits) value = (value << 1) | (c == '1' ? 1 : 0);
+  return value;
+}
+
+std::string toBits(uint64_t value, unsigned width) {
+  std::string bits(width, '0');
+  for (unsigned i = 0; i < width && i < 64; ++i) {
+    if ((value >> i) & 1) bits[width - 1 - i] = '1';
+  }
+  return bits;
+}
+
+}  // namespace
+
+bool SolutionTable::applicable(VariableContainer const& vcon, ConstraintPartition const& cp, unsigned max_bits) {
+  if (vcon.variables.empty() || !vcon.dist_references.empty()) return false;
+  for (ConstraintPtr c : cp) {
+    if (c->isSoft()) return false;
+  }
+  unsigned bits = 0;
+  for (std::pair<int const, NodePtr> const& v : vcon.variables) {
+    bits += static_cast<Terminal const&>(*v.second).bitsize();
+    if (bits > max_bits) return false;
+  }
+  return true;
+}
+
+SolutionTable::SolutionTable(VariableContainer const& vcon, ConstraintPartition const& cp, unsigned max_solutions)
+    : columns_(), values_(), complete_(false) {
+  std::map<int, AssignResult*> write_refs;
+  for (VariableContainer::WriteRefPair const& pair : vcon.write_references) write_refs[pair.first] = pair.second.get();
+  std::map<int, ReferenceExpression*> read_refs;
+  for (VariableContainer::ReadRefPair const& pair : vcon.read_references) read_refs[pair.first] = pair.second.get();
+
+  for (std::pair<int const, NodePtr> const& v : vcon.variables) {
+    Terminal const& t = static_cast<Terminal const&>(*v.second);
+    Column col = {v.first, v.second, t.bitsize(), t.sign(), nullptr, nullptr};
+    if (write_refs.count(v.first)) col.write_ref = write_refs.at(v.first);
+    if (read_refs.count(v.first)) col.read_ref = read_refs.at(v.first);
+    columns_.push_back(col);
+  }
+
+  std::unique_ptr<metaSMTVisitor> solver(FactoryMetaSMT::getNewInstance());
+  for (ConstraintPtr c : cp) {
+    if (!c->isSoft() && !c->isCover()) solver->makeAssertion(*c->expr());
+  }
+  while (solver->solve()) {
+    if (size() == max_solutions) {
+      values_.clear();
+      return;
+    }
+    // block the solution, so the next solve finds another one
+    NodePtr solution;
+    for (Column const& col : columns_) {
+      std::string bits;
+      solver->read(*col.var, bits);
+      uint64_t value = mask(fromBits(bits), col.width);
+      values_.push_back(value);
+      NodePtr eq(new EqualOpr(col.var, new Constant(toConstant(value, col.width, col.sign))));
+      solution = solution ? NodePtr(new LogicalAndOpr(solution, eq)) : eq;
+    }
+    NodePtr block(new NotOpr(solution));
+    solver->makeAssertion(*block);
+  }
+  complete_ = true;
+  LOG(INFO) << "Enumerated " << size() << " solution(s) of partition " << cp;
+}
+
+bool SolutionTable::pick(std::set<int> const& frozen, std::map<int, Constant>* values) const {
+  std::vector<std::pair<unsigned, uint64_t> > fixed;
+  for (unsigned i = 0; i < columns_.size(); ++i) {
+    Column const& col = columns_[i];
+    if (col.read_ref) {
+      // read references are always of the form var == value
+      NodePtr e = col.read_ref->expr();
+      Constant const& value = *static_cast<Constant const*>(static_cast<EqualOpr const&>(*e).rhs().get());
+      fixed.push_back(std::make_pair(i, mask(value.value(), col.width)));
+    } else if (col.write_ref && frozen.count(col.id)) {
+      fixed.push_back(std::make_pair(i, mask(col.write_ref->value_as_constant().value(), col.width)));
+    }
+  }
+
+  unsigned rows = size();
+  unsigned row;
+  if (fixed.empty()) {
+    if (rows == 0) return false;
+    row = random_unsigned(rows);
+  } else {
+    std::vector<unsigned> matching;
+    for (unsigned r = 0; r < rows; ++r) {
+      uint64_t const* solution = &values_[r * columns_.size()];
+      bool match = true;
+      for (std::pair<unsigned, uint64_t> const& f : fixed) match = match && solution[f.first] == f.second;
+      if (match) matching.push_back(r);
+    }
+    if (matching.empty()) return false;
+    row = matching[random_unsigned(matching.size())];
+  }
+
+  uint64_t const* solution = &values_[row * columns_.size()];
+  for (unsigned i = 0; i < columns_.size(); ++i) {
+    Column const& col = columns_[i];
+    (*values)[col.id] = toConstant(solution[i], col.width, col.sign);
+    if (col.write_ref && !frozen.count(col.id)) col.write_ref->set_value(toBits(solution[i], col.width));
+  }
+  return true;
+}
+
+}  // namespace crave
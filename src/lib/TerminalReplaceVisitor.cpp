@@ -0,0 +1,141 @@
+// Copyright 2012-2016 The CRAVE developers, University of Bremen, Germany. All rights reserved.//
+
+#include "../crave/ir/visitor/TerminalReplaceVisitor.hpp"
+
+#include <cassert>
+#include <vector>
+
+namespace crave {
+
+NodePtr TerminalReplaceVisitor::replace(Node const& expr) {
+  expr.visit(this);
+  return pop();
+}
+
+NodePtr TerminalReplaceVisitor::pop() {
+  assert(!stack_.empty());
+  NodePtr n = stack_.top();
+  stack_.pop();
+  return n;
+}
+
+template <typename Opr>
+void TerminalReplaceVisitor::rebuildUnary(UnaryExpression const& u) {
+  u.child()->visit(this);
+  stack_.push(new Opr(pop()));
+}
+
+template <typename Opr>
+void TerminalReplaceVisitor::rebuildBinary(BinaryExpression const& b) {
+  b.lhs()->visit(this);
+  b.rhs()->visit(this);
+  NodePtr rhs = pop();
+  NodePtr lhs = pop();
+  stack_.push(new Opr(lhs, rhs));
+}
+
+void TerminalReplaceVisitor::visitNode(Node const&) {}
+void TerminalReplaceVisitor::visitTerminal(Terminal const&) {}
+void TerminalReplaceVisitor::visitUnaryExpr(UnaryExpression const&) {}
+void TerminalReplaceVisitor::visitUnaryOpr(UnaryOperator const&) {}
+void TerminalReplaceVisitor::visitBinaryExpr(BinaryExpression const&) {}
+void TerminalReplaceVisitor::visitBinaryOpr(BinaryOperator const&) {}
+void TerminalReplaceVisitor::visitTernaryExpr(TernaryExpression const&) {}
+
+void TerminalReplaceVisitor::visitPlaceholder(Placeholder const& p) { stack_.push(new Placeholder(p.id())); }
+
+void TerminalReplaceVisitor::visitVariableExpr(VariableExpr const& v) {
+  NodePtr n = variables_ ? variables_(v) : NodePtr();
+  stack_.push(n ? n : NodePtr(new VariableExpr(v)));
+}
+
+void TerminalReplaceVisitor::visitConstant(Constant const& c) {
+  NodePtr n = constants_ ? constants_(c) : NodePtr();
+  stack_.push(n ? n : NodePtr(new Constant(c)));
+}
+
+void TerminalReplaceVisitor::visitVectorExpr(VectorExpr const& v) { stack_.push(new VectorExpr(v)); }
+
+void TerminalReplaceVisitor::visitNotOpr(NotOpr const& n) { rebuildUnary<NotOpr>(n); }
+
+void TerminalReplaceVisitor::visitNegOpr(NegOpr const& n) { rebuildUnary<NegOpr>(n); }
+
+void TerminalReplaceVisitor::visitComplementOpr(ComplementOpr const& c) { rebuildUnary<ComplementOpr>(c); }
+
+void TerminalReplaceVisitor::visitInside(Inside const& i) {
+  i.child()->visit(this);
+  stack_.push(new Inside(pop(), i.collection()));
+}
+
+void TerminalReplaceVisitor::visitExtendExpr(ExtendExpression const& e) {
+  e.child()->visit(this);
+  stack_.push(new ExtendExpression(pop(), e.value()));
+}
+
+void TerminalReplaceVisitor::visitAndOpr(AndOpr const& a) { rebuildBinary<AndOpr>(a); }
+
+void TerminalReplaceVisitor::visitOrOpr(OrOpr const& o) { rebuildBinary<OrOpr>(o); }
+
+void TerminalReplaceVisitor::visitLogicalAndOpr(LogicalAndOpr const& la) { rebuildBinary<LogicalAndOpr>(la); }
+
+void TerminalReplaceVisitor::visitLogicalOrOpr(LogicalOrOpr const& lo) { rebuildBinary<LogicalOrOpr>(lo); }
+
+void TerminalReplaceVisitor::visitXorOpr(XorOpr const& x) { rebuildBinary<XorOpr>(x); }
+
+void TerminalReplaceVisitor::visitEqualOpr(EqualOpr const& eq) { rebuildBinary<EqualOpr>(eq); }
+
+void TerminalReplaceVisitor::visitNotEqualOpr(NotEqualOpr const& neq) { rebuildBinary<NotEqualOpr>(neq); }
+
+void TerminalReplaceVisitor::visitLessOpr(LessOpr const& l) { rebuildBinary<LessOpr>(l); }
+
+void TerminalReplaceVisitor::visitLessEqualOpr(LessEqualOpr const& le) { rebuildBinary<LessEqualOpr>(le); }
+
+void TerminalReplaceVisitor::visitGreaterOpr(GreaterOpr const& g) { rebuildBinary<GreaterOpr>(g); }
+
+void TerminalReplaceVisitor::visitGreaterEqualOpr(GreaterEqualOpr const& ge) { rebuildBinary<GreaterEqualOpr>(ge); }
+
+void TerminalReplaceVisitor::visitPlusOpr(PlusOpr const& p) { rebuildBinary<PlusOpr>(p); }
+
+void TerminalReplaceVisitor::visitMinusOpr(MinusOpr const& m) { rebuildBinary<MinusOpr>(m); }
+
+void TerminalReplaceVisitor::visitMultipliesOpr(MultipliesOpr const& m) { rebuildBinary<MultipliesOpr>(m); }
+
+void TerminalReplaceVisitor::visitDevideOpr(DevideOpr const& d) { rebuildBinary<DevideOpr>(d); }
+
+void TerminalReplaceVisitor::visitModuloOpr(ModuloOpr const& m) { rebuildBinary<ModuloOpr>(m); }
+
+void TerminalReplaceVisitor::visitShiftLeftOpr(ShiftLeftOpr const& shl) { rebuildBinary<ShiftLeftOpr>(shl); }
+
+void TerminalReplaceVisitor::visitShiftRightOpr(ShiftRightOpr const& shr) { rebuildBinary<ShiftRightOpr>(shr); }
+
+void TerminalReplaceVisitor::visitVectorAccess(VectorAccess const& v) { rebuildBinary<VectorAccess>(v); }
+
+void TerminalReplaceVisitor::visitIfThenElse(IfThenElse const& ite) {
+  ite.a()->visit(this);
+  ite.b()->visit(this);
+  ite.c()->visit(this);
+  NodePtr c = pop();
+  NodePtr b = pop();
+  NodePtr a = pop();
+  stack_.push(new IfThenElse(a, b, c));
+}
+
+void TerminalReplaceVisitor::visitForEach(ForEach const& fe) { rebuildBinary<ForEach>(fe); }
+
+void TerminalReplaceVisitor::visitUnique(Unique const& u) { rebuildUnary<Unique>(u); }
+
+void TerminalReplaceVisitor::visitBitslice(Bitslice const& b) {
+  b.child()->visit(this);
+  stack_.push(new Bitslice(pop(), b.r(), b.l()));
+}
+
+void TerminalReplaceVisitor::visitReduction(Reduction const& r) {
+  std::vector<NodePtr> operands;
+  for (NodePtr const& op : r.operands()) {
+    op->visit(this);
+    operands.push_back(pop());
+  }
+  stack_.push(new Reduction(r.kind(), operands));
+}
+
+}  // end namespace crave
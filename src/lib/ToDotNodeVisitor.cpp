@@ -178,4 +178,16 @@ void ToDotVisitor::visitBitslice(Bitslice const &b) {
   visitUnaryExpr(b);
 }
 
+void ToDotVisitor::visitReduction(Reduction const &r) {
+  static char const* const names[] = {"sum", "and_reduce", "or_reduce", "xor_reduce"};
+  if (putNode(&r)) {
+    visitNode(r);
+    out_ << " [label=\"" << names[r.kind()] << "\"]" << std::endl;
+  }
+  for(NodePtr const& n : r.operands()) {
+    n->visit(this);
+    out_ << "\t" << reinterpret_cast<long>(&r) << " -> " << reinterpret_cast<long>(n.get()) << std::endl;
+  }
+}
+
 }  // namespace crave
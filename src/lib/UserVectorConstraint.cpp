@@ -5,11 +5,24 @@ namespace crave {
 UserVectorConstraint::UserVectorConstraint(unsigned const id, UserVectorConstraint::expression const expr,
                                            std::string const& name, std::set<int> support_vars, bool const unique,
                                            bool const soft, bool const cover, bool const enabled)
-    : UserConstraint(id, expr, name, support_vars, soft, cover, enabled), unique_(unique) {}
+    : UserConstraint(id, expr, name, support_vars, soft, cover, enabled), unique_(unique), index_offsets_(), irregular_index_(false) {}
 
 bool UserVectorConstraint::isUnique() { return unique_; }
 
 int UserVectorConstraint::getVectorId() { return *support_vars_.begin(); }
 
 bool UserVectorConstraint::isVectorConstraint() { return true; }
+
+std::set<int> const& UserVectorConstraint::indexOffsets() { return index_offsets_; }
+
+bool UserVectorConstraint::hasIrregularIndex() { return irregular_index_; }
+
+bool UserVectorConstraint::hasBoundedOffsets() {
+  // only vec[placeholder + c] is accessed and no other variable couples the elements
+  return !unique_ && !irregular_index_ && support_vars_.size() == 1;
+}
+
+bool UserVectorConstraint::isElementLocal() {
+  return hasBoundedOffsets() && index_offsets_.size() == 1 && *index_offsets_.begin() == 0;
+}
 }
@@ -1,8 +1,14 @@
 #include "../crave/backend/VariableCoverageSolver.hpp"
 #include "../crave/utils/Logging.hpp"
 
+#include <algorithm>
+
 namespace crave {
 
+unsigned VariableCoverageSolver::batch_size = 16;
+
+bool VariableCoverageSolver::hit_multiple_bins = false;
+
 VariableCoverageSolver::VariableCoverageSolver(const VariableContainer& vcon, const ConstraintPartition& cp)
     : VariableSolver(vcon, cp) {
   LOG(INFO) << "Create coverage solver for partition " << constr_pttn_;
@@ -15,24 +21,104 @@ VariableCoverageSolver::VariableCoverageSolver(const VariableContainer& vcon, co
   }
 }
 
+std::vector<uint64_t> VariableCoverageSolver::readRefValues() const {
+  std::vector<uint64_t> values;
+  for(VariableContainer::ReadRefPair const & pair : var_ctn_.read_references) {
+    // read references are always of the form var == value
+    NodePtr expr = pair.second->expr();
+    values.push_back(static_cast<Constant const*>(static_cast<EqualOpr const*>(expr.get())->rhs().get())->value());
+  }
+  // frozen variables restrict the reachable constraints like read references
+  for(VariableContainer::WriteRefPair const & pair : var_ctn_.write_references) {
+    if (!frozen_variables_.count(pair.first)) continue;
+    values.push_back(pair.first);
+    values.push_back(pair.second->value_as_constant().value());
+  }
+  return values;
+}
+
+void VariableCoverageSolver::makeAssumptions() {
+  for(VariableContainer::ReadRefPair & pair : var_ctn_.read_references) {
+    solver_->makeAssumption(*pair.second->expr());
+  }
+  if (frozen_variables_.empty()) return;
+  for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
+    if (!frozen_variables_.count(pair.first)) continue;
+    EqualOpr eq(var_ctn_.variables[pair.first], new Constant(pair.second->value_as_constant()));
+    solver_->makeAssumption(eq);
+  }
+}
+
+ConstraintPtr VariableCoverageSolver::solveBatch(ConstraintIterator first, ConstraintIterator last) {
+  NodePtr any = (*first)->expr();
+  for (ConstraintIterator ite = first + 1; ite != last; ++ite) any = new LogicalOrOpr(any, (*ite)->expr());
+
+  makeAssumptions();
+  solver_->makeAssumption(*any);
+  if (!solver_->solve()) {
+    for (ConstraintIterator ite = first; ite != last; ++ite) {
+      unreachable_set_.insert((*ite)->name());
+      failures_[(*ite)->name()]++;
+    }
+    return ConstraintPtr();
+  }
+  if (last - first == 1) return *first;  // the current solution hits this constraint
+
+  // bisect to find a single constraint that can be hit
+  ConstraintIterator mid = first + (last - first) / 2;
+  ConstraintPtr hit = solveBatch(first, mid);
+  return hit ? hit : solveBatch(mid, last);
+}
+
+bool VariableCoverageSolver::solveAll(std::vector<ConstraintPtr> const& hits) {
+  makeAssumptions();
+  for(ConstraintPtr c : hits) solver_->makeAssumption(*c->expr());
+  return solver_->solve();
+}
+
 bool VariableCoverageSolver::solve() {
+  std::vector<uint64_t> values = readRefValues();
+  if (values != unreachable_values_) {
+    unreachable_set_.clear();
+    unreachable_values_ = values;
+  }
 
+  std::vector<ConstraintPtr> candidates;
   for(ConstraintPtr c : constr_pttn_) {
     if (!c->isCover()) continue;
-    if (covered_set_.find(c->name()) != covered_set_.end()) {
-      continue;  // alread covered
-    }
-    // try solve
+    if (covered_set_.find(c->name()) != covered_set_.end()) continue;        // already covered
+    if (unreachable_set_.find(c->name()) != unreachable_set_.end()) continue;  // not coverable right now
+    candidates.push_back(c);
+  }
+  // try constraints that failed less often first
+  std::stable_sort(candidates.begin(), candidates.end(), [this](ConstraintPtr a, ConstraintPtr b) {
+    return failures_[a->name()] < failures_[b->name()];
+  });
 
-    for(VariableContainer::ReadRefPair & pair : var_ctn_.read_references) {
-      solver_->makeAssumption(*pair.second->expr());
-    }
-    solver_->makeAssumption(*c->expr());
-    if (solver_->solve()) {
-      LOG(INFO) << "Solve partition " << constr_pttn_ << " hitting constraint " << c->name();
-      covered_set_.insert(c->name());
+  unsigned step = std::max(batch_size, 1u);
+  for (unsigned i = 0; i < candidates.size(); i += step) {
+    unsigned end = std::min<unsigned>(i + step, candidates.size());
+    ConstraintPtr c = solveBatch(candidates.begin() + i, candidates.begin() + end);
+    if (c) {
+      std::vector<ConstraintPtr> hits(1, c);
+      if (hit_multiple_bins) {
+        bool solved = true;
+        for (unsigned j = i; j < candidates.size(); ++j) {
+          if (candidates[j] == c || unreachable_set_.find(candidates[j]->name()) != unreachable_set_.end()) continue;
+          hits.push_back(candidates[j]);
+          solved = solveAll(hits);
+          if (!solved) hits.pop_back();
+        }
+        if (!solved) solveAll(hits);  // restore the solution of the last successful extension
+      }
+
+      for(ConstraintPtr hit : hits) {
+        LOG(INFO) << "Solve partition " << constr_pttn_ << " hitting constraint " << hit->name();
+        covered_set_.insert(hit->name());
+      }
 
       for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
+        if (frozen_variables_.count(pair.first)) continue;
         solver_->read(*var_ctn_.variables[pair.first], *pair.second);
       }
       return true;
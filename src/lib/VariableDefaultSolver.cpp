@@ -5,6 +5,7 @@
 #include <functional>
 #include <algorithm>
 #include <memory>
+#include <stdexcept>
 
 namespace crave {
 
@@ -12,22 +13,50 @@ extern std::function<unsigned(unsigned)> random_unsigned;
 
 bool VariableDefaultSolver::bypass_constraint_analysis = false;
 
+bool VariableDefaultSolver::bypass_variable_elimination = false;
+
 unsigned VariableDefaultSolver::complexity_limit_for_bdd = 400;
 
+unsigned VariableDefaultSolver::complexity_limit_for_partition_bdd = 0;
+
+unsigned VariableDefaultSolver::solution_table_max_bits = 10;
+
+unsigned VariableDefaultSolver::solution_table_max_solutions = 1024;
+
+unsigned long VariableDefaultSolver::solved_by_table = 0;
+
+unsigned VariableDefaultSolver::rejection_sampling_candidates = 64;
+
+unsigned long VariableDefaultSolver::solved_by_sampling = 0;
+
+unsigned long VariableDefaultSolver::dropped_samplers = 0;
+
 VariableDefaultSolver::VariableDefaultSolver(const VariableContainer& vcon, const ConstraintPartition& cp)
-    : VariableSolver(vcon, cp) {
+    : VariableSolver(vcon, cp), num_solves_(0) {
   LOG(INFO) << "Create solver for partition " << constr_pttn_;
 
+  if (complexity_limit_for_partition_bdd > 0 && FactorySolver<CUDD>::isDefined()) buildPartitionBdd();
+  if (rejection_sampling_candidates > 0 && !partition_bdd_ && RejectionSampler::applicable(var_ctn_, constr_pttn_))
+    sampler_ = std::make_shared<RejectionSampler>(var_ctn_, constr_pttn_);
+
+  // a BDD sampled partition keeps its variables, the SMT solver only handles frozen variables then
+  if (!bypass_variable_elimination && !partition_bdd_) {
+    elimination_ = std::make_shared<VariableElimination>(var_ctn_, constr_pttn_);
+    if (elimination_->empty()) elimination_.reset();
+  }
+
   for(ConstraintPtr c : constr_pttn_) {
     if (c->isCover()) continue;  // default solver ignores cover constraints
+    if (elimination_ && elimination_->isDefinition(*c)) continue;
+    NodePtr expr = elimination_ ? elimination_->substitute(c->expr()) : c->expr();
     if (c->isSoft()) {
-      solver_->makeSoftAssertion(*c->expr());
+      solver_->makeSoftAssertion(*expr);
     } else {
-      solver_->makeAssertion(*c->expr());
+      solver_->makeAssertion(*expr);
     }
   }
 
-  if (bypass_constraint_analysis) return;
+  if (bypass_constraint_analysis || partition_bdd_) return;
 
   analyseConstraints();
 
@@ -43,6 +72,7 @@ VariableDefaultSolver::VariableDefaultSolver(const VariableContainer& vcon, cons
     for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
       int id = pair.first;
       if (svc_map.find(id) == svc_map.end()) continue;
+      if (elimination_ && elimination_->isEliminated(id)) continue;
       if (vars_with_dist.find(id) != vars_with_dist.end()) {
         LOG(INFO) << "  Skip var #" << id << " due to existing distribution constraints";
         continue;
@@ -60,6 +90,7 @@ VariableDefaultSolver::VariableDefaultSolver(const VariableContainer& vcon, cons
   if (2 * vars_with_dist.size() > var_ctn_.write_references.size()) return;  // not necessary to randomize more
 
   for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
+    if (elimination_ && elimination_->isEliminated(pair.first)) continue;
     if (vars_with_dist.find(pair.first) == vars_with_dist.end()) random_write_refs_.push_back(pair);
   }
 }
@@ -89,9 +120,66 @@ bool VariableDefaultSolver::solve() {
     LOG(INFO) << "Failed because partition has been analyzed to be unsolvable";
     return false;
   }
+
+  unsigned num_frozen = 0;
+  if (!frozen_variables_.empty()) {
+    for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
+      if (frozen_variables_.count(pair.first)) num_frozen++;
+    }
+    bool result;
+    if (num_frozen > 0 && num_frozen == var_ctn_.write_references.size() && evaluateFrozen(&result)) {
+      LOG(INFO) << "Skip solving, all variables of partition are frozen";
+      return result;
+    }
+  }
+
+  // a solver that is reused amortizes the enumeration of the solutions
+  if (++num_solves_ == 2 && !partition_bdd_ && solution_table_max_bits > 0 &&
+      SolutionTable::applicable(var_ctn_, constr_pttn_, solution_table_max_bits)) {
+    table_ = std::make_shared<SolutionTable>(var_ctn_, constr_pttn_, solution_table_max_solutions);
+    if (!table_->complete()) table_.reset();
+  }
+  if (table_) {
+    if (!table_->pick(frozen_variables_, &computed_values_)) {
+      LOG(INFO) << "Failed due to conflict with read references";
+      return false;
+    }
+    LOG(INFO) << "Done picking solution of partition " << constr_pttn_ << " from table";
+    ++solved_by_table;
+    return true;
+  }
+
+  if (partition_bdd_ && num_frozen == 0) {
+    CHECK(partition_bdd_->solve());  // checked when the BDD was built
+    model_ = partition_bdd_;
+    for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
+      partition_bdd_->read(*var_ctn_.variables[pair.first], *pair.second);
+    }
+    LOG(INFO) << "Done sampling partition " << constr_pttn_ << " from BDD";
+    return true;
+  }
+
+  computed_values_.clear();
+  if (sampler_) {
+    if (sampler_->sample(rejection_sampling_candidates, frozen_variables_, &computed_values_)) {
+      LOG(INFO) << "Done sampling partition " << constr_pttn_ << " by rejection";
+      ++solved_by_sampling;
+      return true;
+    }
+    computed_values_.clear();
+    if (sampler_->tried() >= 4 * rejection_sampling_candidates &&
+        sampler_->accepted() * rejection_sampling_candidates < sampler_->tried()) {
+      LOG(INFO) << "Stop rejection sampling, accepted " << sampler_->accepted() << " of " << sampler_->tried()
+                << " candidates";
+      sampler_.reset();
+      ++dropped_samplers;
+    }
+  }
+
   for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
     int id = pair.first;
     if (bdd_solvers_.find(id) == bdd_solvers_.end()) continue;
+    if (num_frozen > 0 && frozen_variables_.count(id)) continue;
     SolverPtr bdd_solver = bdd_solvers_[id];
     CHECK(bdd_solver->solve());  // otherwise, contradiction must have been found!
     std::string str;
@@ -106,6 +194,17 @@ bool VariableDefaultSolver::solve() {
     solver_->makeAssumption(*pair.second->expr());
   }
 
+  if (num_frozen > 0) {
+    for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
+      if (!frozen_variables_.count(pair.first)) continue;
+      NodePtr value(new Constant(pair.second->value_as_constant()));
+      NodePtr var = var_ctn_.variables[pair.first];
+      if (elimination_ && elimination_->isEliminated(pair.first)) var = elimination_->substitute(var);
+      NodePtr eq(new EqualOpr(var, value));
+      solver_->makeAssumption(*eq);
+    }
+  }
+
   for(VariableContainer::ReadRefPair & pair : var_ctn_.dist_references) {
     solver_->makeSuggestion(*pair.second->expr());
   }
@@ -113,6 +212,7 @@ bool VariableDefaultSolver::solve() {
   if (!random_write_refs_.empty()) {
     std::random_shuffle(random_write_refs_.begin(), random_write_refs_.end(), crave::random_unsigned);
     for (unsigned i = 0; i < (random_write_refs_.size() + 1) / 2; i++) {
+      if (num_frozen > 0 && frozen_variables_.count(random_write_refs_[i].first)) continue;
       NodePtr value(new Constant(random_write_refs_[i].second->value_as_constant()));  // reuse the random value generated by next()
       NodePtr var = var_ctn_.variables[random_write_refs_[i].first];
       NodePtr eq(new EqualOpr(var, value));
@@ -120,10 +220,17 @@ bool VariableDefaultSolver::solve() {
     }
   }
 
+  model_ = solver_;
   if (solver_->solve()) {
     for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
+      if (num_frozen > 0 && frozen_variables_.count(pair.first)) continue;
+      if (elimination_ && elimination_->isEliminated(pair.first)) continue;
       solver_->read(*var_ctn_.variables[pair.first], *pair.second);
     }
+    if (elimination_ && !elimination_->evaluate(frozen_variables_, &computed_values_)) {
+      LOG(INFO) << "Failed to evaluate eliminated variables";
+      return false;
+    }
     LOG(INFO) << "Done solving partition " << constr_pttn_;
     return true;
   }
@@ -131,6 +238,56 @@ bool VariableDefaultSolver::solve() {
   return false;
 }
 
+bool VariableDefaultSolver::evaluateFrozen(bool* result) {
+  for(VariableContainer::WriteRefPair & pair : var_ctn_.write_references) {
+    frozen_evaluator_.assign(static_cast<unsigned>(pair.first), pair.second->value_as_constant());
+  }
+  for(VariableContainer::ReadRefPair & pair : var_ctn_.read_references) {
+    NodePtr e = pair.second->expr();
+    EqualOpr const* eq = dynamic_cast<EqualOpr const*>(e.get());
+    Constant const* c = eq ? dynamic_cast<Constant const*>(eq->rhs().get()) : nullptr;
+    if (!c) return false;
+    frozen_evaluator_.assign(static_cast<unsigned>(pair.first), *c);
+  }
+  for(ConstraintPtr c : constr_pttn_) {
+    if (c->isSoft() || c->isCover()) continue;
+    if (!frozen_evaluator_.evaluate(boost::proto::make_expr<boost::proto::tag::terminal, Constraint_Domain>(c->expr())))
+      return false;
+    if (!frozen_evaluator_.result<bool>()) {
+      *result = false;
+      return true;
+    }
+  }
+  *result = true;
+  return true;
+}
+
+void VariableDefaultSolver::buildPartitionBdd() {
+  // samples of the BDD cannot take assumptions or suggestions, so references and softs need the SMT solver
+  if (!var_ctn_.read_references.empty() || !var_ctn_.dist_references.empty()) return;
+  unsigned complexity = 0;
+  for(ConstraintPtr c : constr_pttn_) {
+    if (c->isCover()) continue;
+    if (c->isSoft() || c->complexity() == 0) return;
+    complexity += c->complexity();
+    if (complexity >= complexity_limit_for_partition_bdd) return;
+  }
+
+  SolverPtr bdd(FactoryMetaSMT::getNewInstance(CUDD));
+  try {
+    for(ConstraintPtr c : constr_pttn_) {
+      if (!c->isCover()) bdd->makeAssertion(*c->expr());
+    }
+    // unsatisfiable partitions are left to the constraint analysis
+    if (!bdd->solve()) return;
+  } catch (std::exception const& e) {
+    LOG(INFO) << "Building the BDD of the partition failed (" << e.what() << "), use the SMT solver";
+    return;
+  }
+  partition_bdd_ = bdd;
+  LOG(INFO) << "Sample partition from BDD, complexity " << complexity;
+}
+
 void VariableDefaultSolver::analyseHards() {
   std::unique_ptr<metaSMTVisitor> solver(FactoryMetaSMT::getNewInstance());
 
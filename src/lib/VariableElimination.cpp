@@ -0,0 +1,205 @@
+#include "../crave/backend/VariableElimination.hpp"
+#include "../crave/ir/visitor/GetSupportSetVisitor.hpp"
+#include "../crave/ir/visitor/TerminalReplaceVisitor.hpp"
+#include "../crave/utils/Logging.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace crave {
+
+namespace {
+
+std::set<int> supportSet(NodePtr const& expr) {
+  GetSupportSetVisitor gssv;
+  expr->visit(&gssv);
+  return gssv.getSupportVars();
+}
+
+// a variable or constant, possibly extended, whose value is held exactly by the evaluator
+Terminal const* exactTerminal(Node const& n, unsigned* width) {
+  unsigned extend = 0;
+  Node const* t = &n;
+  if (ExtendExpression const* e = dynamic_cast<ExtendExpression const*>(t)) {
+    extend = e->value();
+    t = e->child().get();
+  }
+  if (!dynamic_cast<VariableExpr const*>(t) && !dynamic_cast<Constant const*>(t)) return nullptr;
+  Terminal const* term = static_cast<Terminal const*>(t);
+  // an extended boolean is sign extended by the solver
+  if (extend > 0 && term->bitsize() == 1) return nullptr;
+  *width = term->bitsize() + extend;
+  return term;
+}
+
+// whether the bits of the width of the comparison have the same value in the evaluator, which compares 64 bit values
+bool isNonNegative(Terminal const& t, unsigned width) {
+  Constant const* c = dynamic_cast<Constant const*>(&t);
+  if (!c || c->sign()) return false;
+  return c->bitsize() < width || !((c->value() >> (width - 1)) & 1);
+}
+
+bool isComparable(BinaryExpression const& b, bool ordering) {
+  unsigned lw, rw;
+  Terminal const* lhs = exactTerminal(*b.lhs(), &lw);
+  Terminal const* rhs = exactTerminal(*b.rhs(), &rw);
+  if (!lhs || !rhs) return false;
+  // the evaluator compares unsigned
+  if (ordering) return !lhs->sign() && !rhs->sign();
+  unsigned width = std::max(lw, rw);
+  return lhs->sign() == rhs->sign() || isNonNegative(*lhs, width) || isNonNegative(*rhs, width);
+}
+
+bool isBoolean(Node const& n) {
+  if (dynamic_cast<EqualOpr const*>(&n) || dynamic_cast<NotEqualOpr const*>(&n))
+    return isComparable(static_cast<BinaryExpression const&>(n), false);
+  if (dynamic_cast<LessOpr const*>(&n) || dynamic_cast<LessEqualOpr const*>(&n) ||
+      dynamic_cast<GreaterOpr const*>(&n) || dynamic_cast<GreaterEqualOpr const*>(&n))
+    return isComparable(static_cast<BinaryExpression const&>(n), true);
+  if (dynamic_cast<LogicalAndOpr const*>(&n) || dynamic_cast<LogicalOrOpr const*>(&n)) {
+    BinaryExpression const& b = static_cast<BinaryExpression const&>(n);
+    return isBoolean(*b.lhs()) && isBoolean(*b.rhs());
+  }
+  if (NotOpr const* u = dynamic_cast<NotOpr const*>(&n)) return isBoolean(*u->child());
+  VariableExpr const* v = dynamic_cast<VariableExpr const*>(&n);
+  return v && v->bitsize() == 1;
+}
+
+// whether the evaluator computes the low bits of the expression exactly, higher bits may differ due to overflows
+bool isModular(Node const& n) {
+  unsigned width;
+  if (exactTerminal(n, &width) || isBoolean(n)) return true;
+  if (dynamic_cast<PlusOpr const*>(&n) || dynamic_cast<MinusOpr const*>(&n) || dynamic_cast<MultipliesOpr const*>(&n) ||
+      dynamic_cast<AndOpr const*>(&n) || dynamic_cast<OrOpr const*>(&n) || dynamic_cast<XorOpr const*>(&n)) {
+    BinaryExpression const& b = static_cast<BinaryExpression const&>(n);
+    return isModular(*b.lhs()) && isModular(*b.rhs());
+  }
+  if (dynamic_cast<NegOpr const*>(&n) || dynamic_cast<ComplementOpr const*>(&n))
+    return isModular(*static_cast<UnaryExpression const&>(n).child());
+  if (IfThenElse const* ite = dynamic_cast<IfThenElse const*>(&n))
+    return isBoolean(*ite->a()) && isModular(*ite->b()) && isModular(*ite->c());
+  return false;
+}
+
+// keeps the bits of the width, signed values are sign extended like the ones of Context and AssignResult
+Constant truncate(uint64_t value, unsigned width, bool sign) {
+  if (width < 64) {
+    value &= (1ULL << width) - 1;
+    if (sign && width > 1 && ((value >> (width - 1)) & 1)) value |= ~((1ULL << width) - 1);
+  }
+  return Constant(value, width, sign);
+}
+
+std::string toBits(Constant const& c) {
+  std::string bits(c.bitsize(), '0');
+  for (unsigned i = 0; i < c.bitsize(); ++i) {
+    if ((c.value() >> std::min(i, 63u)) & 1) bits[c.bitsize() - 1 - i] = '1';
+  }
+  return bits;
+}
+
+}  // namespace
+
+VariableElimination::VariableElimination(VariableContainer const& vcon, ConstraintPartition const& cp)
+    : write_refs_(), read_refs_(), excluded_(), definitions_(), defining_(), order_(), substituted_(), evaluator_() {
+  for (VariableContainer::WriteRefPair const& pair : vcon.write_references) write_refs_[pair.first] = pair.second.get();
+  for (VariableContainer::ReadRefPair const& pair : vcon.read_references) {
+    read_refs_[pair.first] = pair.second.get();
+    excluded_.insert(pair.first);
+  }
+  for (VariableContainer::ReadRefPair const& pair : vcon.dist_references) excluded_.insert(pair.first);
+  for (std::pair<int const, int> const& dist : vcon.dist_ref_to_var_map) excluded_.insert(dist.second);
+
+  for (ConstraintPtr c : cp) {
+    if (c->isSoft() || c->isCover()) continue;
+    EqualOpr const* eq = dynamic_cast<EqualOpr const*>(c->expr().get());
+    if (!eq) continue;
+    VariableExpr const* lhs = dynamic_cast<VariableExpr const*>(eq->lhs().get());
+    VariableExpr const* rhs = dynamic_cast<VariableExpr const*>(eq->rhs().get());
+    if ((lhs && define(lhs->id(), eq->lhs(), eq->rhs())) || (rhs && define(rhs->id(), eq->rhs(), eq->lhs())))
+      defining_.insert(c.get());
+  }
+
+  std::set<int> visited;
+  for (std::pair<int const, Definition> const& def : definitions_) sort(def.first, &visited);
+  if (!definitions_.empty()) {
+    LOG(INFO) << "Eliminated " << definitions_.size() << " defined variable(s)";
+  }
+}
+
+bool VariableElimination::define(int id, NodePtr const& var, NodePtr const& expr) {
+  if (excluded_.count(id) || definitions_.count(id) || !isModular(*expr)) return false;
+
+  Definition def;
+  def.var = var;
+  def.expr = expr;
+  def.support = supportSet(expr);
+  for (int v : def.support) {
+    std::map<int, Definition>::const_iterator ite = definitions_.find(v);
+    if (ite != definitions_.end()) {
+      def.sources.insert(ite->second.sources.begin(), ite->second.sources.end());
+    } else if (write_refs_.count(v) || read_refs_.count(v)) {
+      def.sources.insert(v);
+    } else {
+      return false;  // the value of a plain variable is not known after solving
+    }
+  }
+  if (def.sources.count(id)) return false;  // cyclic
+
+  for (std::pair<int const, Definition>& other : definitions_) {
+    if (!other.second.sources.erase(id)) continue;
+    other.second.sources.insert(def.sources.begin(), def.sources.end());
+  }
+  definitions_[id] = def;
+  return true;
+}
+
+void VariableElimination::sort(int id, std::set<int>* visited) {
+  if (!visited->insert(id).second) return;
+  for (int v : definitions_.at(id).support) {
+    if (definitions_.count(v)) sort(v, visited);
+  }
+  order_.push_back(id);
+}
+
+NodePtr VariableElimination::substitute(NodePtr const& expr) {
+  TerminalReplaceVisitor replace(TerminalReplaceVisitor::constant_function(), [this](VariableExpr const& v) {
+    std::map<int, Definition>::const_iterator def = definitions_.find(v.id());
+    if (def == definitions_.end()) return NodePtr();
+    std::map<int, NodePtr>::const_iterator ite = substituted_.find(v.id());
+    if (ite != substituted_.end()) return ite->second;
+    NodePtr result = substitute(def->second.expr);
+    substituted_[v.id()] = result;
+    return result;
+  });
+  return replace.replace(*expr);
+}
+
+bool VariableElimination::evaluate(std::set<int> const& frozen, std::map<int, Constant>* values) {
+  for (std::pair<int const, AssignResult*> const& ref : write_refs_) {
+    if (definitions_.count(ref.first)) continue;
+    evaluator_.assign(static_cast<unsigned>(ref.first), ref.second->value_as_constant());
+  }
+  for (std::pair<int const, ReferenceExpression*> const& ref : read_refs_) {
+    // read references are always of the form var == value
+    NodePtr e = ref.second->expr();
+    Constant const& value = *static_cast<Constant const*>(static_cast<EqualOpr const&>(*e).rhs().get());
+    evaluator_.assign(static_cast<unsigned>(ref.first), value);
+  }
+
+  for (int id : order_) {
+    Definition const& def = definitions_.at(id);
+    if (!evaluator_.evaluate(boost::proto::make_expr<boost::proto::tag::terminal, Constraint_Domain>(def.expr)))
+      return false;
+    Terminal const& var = static_cast<Terminal const&>(*def.var);
+    Constant value = truncate(evaluator_.result<uint64_t>(), var.bitsize(), var.sign());
+    evaluator_.assign(static_cast<unsigned>(id), value);
+    (*values)[id] = value;
+
+    std::map<int, AssignResult*>::const_iterator ref = write_refs_.find(id);
+    if (ref != write_refs_.end() && !frozen.count(id)) ref->second->set_value(toBits(value));
+  }
+  return true;
+}
+
+}  // namespace crave
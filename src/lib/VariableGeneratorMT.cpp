@@ -14,9 +14,10 @@ void joinAll(std::vector<std::thread*> threads) {
 }
 
 void VariableGeneratorMT::reset(std::vector<ConstraintPartition>& partitions) {
-  solvers_.resize(partitions.size());
+  solvers_ = reuseSolvers(partitions);
   std::vector<std::thread*> threads;
   for (unsigned i = 0; i < partitions.size(); i++) {
+    if (solvers_[i]) continue;
     std::thread* thread(
         new std::thread(&VariableGeneratorMT::createNewSolver, this, std::ref(partitions.at(i)), i));
     threads.push_back(thread);
@@ -1,16 +1,45 @@
 #include "../crave/backend/VariableGeneratorType.hpp"
 #include "../crave/backend/VariableDefaultSolver.hpp"
+#include "../crave/utils/Logging.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
 
 namespace crave {
-VariableGenerator::VariableGenerator(const VariableContainer& vcon) : var_ctn_(vcon), solvers_() {}
+VariableGenerator::VariableGenerator(const VariableContainer& vcon) : var_ctn_(vcon), solvers_(), stale_() {}
 
 void VariableGenerator::reset(std::vector<ConstraintPartition>& partitions) {
+  solvers_ = reuseSolvers(partitions);
+
+  for (unsigned i = 0; i < partitions.size(); i++) {
+    if (!solvers_[i]) solvers_[i].reset(new VariableDefaultSolver(var_ctn_, partitions[i]));
+  }
+}
+
+std::vector<VariableGenerator::VarSolverPtr> VariableGenerator::reuseSolvers(
+    std::vector<ConstraintPartition> const& partitions) {
+  // partitions are disjoint, so the first constraint identifies the only candidate
+  std::map<UserConstraint const*, VarSolverPtr> by_first;
+  for(VarSolverPtr vs : solvers_) {
+    if (vs->constr_pttn_.begin() != vs->constr_pttn_.end()) by_first[vs->constr_pttn_.begin()->get()] = vs;
+  }
   solvers_.clear();
+  stale_.clear();
 
-  for(ConstraintPartition & partition : partitions) {
-    VarSolverPtr vs(new VariableDefaultSolver(var_ctn_, partition));
-    solvers_.push_back(vs);
+  std::vector<VarSolverPtr> result(partitions.size());
+  for (unsigned i = 0; i < partitions.size(); i++) {
+    ConstraintPartition const& cp = partitions[i];
+    if (cp.begin() == cp.end()) continue;
+    std::map<UserConstraint const*, VarSolverPtr>::iterator ite = by_first.find(cp.begin()->get());
+    if (ite == by_first.end()) continue;
+    ConstraintPartition const& old = ite->second->constr_pttn_;
+    if (std::distance(cp.begin(), cp.end()) != std::distance(old.begin(), old.end())) continue;
+    if (!std::equal(cp.begin(), cp.end(), old.begin())) continue;
+    LOG(INFO) << "Reuse solver for partition " << cp;
+    result[i] = ite->second;
   }
+  return result;
 }
 
 bool VariableGenerator::solve() {
@@ -20,6 +49,25 @@ bool VariableGenerator::solve() {
   return true;
 }
 
+bool VariableGenerator::materialize() {
+  for (unsigned i = 0; i < stale_.size(); i++) {
+    if (!stale_[i]) continue;
+    stale_[i] = false;
+    if (!solvers_[i]->solve()) return false;
+  }
+  return true;
+}
+
+bool VariableGenerator::materialize(int id) {
+  for (unsigned i = 0; i < stale_.size(); i++) {
+    if (solvers_[i]->var_ctn_.variables.find(id) == solvers_[i]->var_ctn_.variables.end()) continue;
+    if (!stale_[i]) return true;
+    stale_[i] = false;
+    return solvers_[i]->solve();
+  }
+  return true;
+}
+
 std::vector<std::vector<std::string> > VariableGenerator::analyseContradiction() {
   std::vector<std::vector<std::string> > str_vec;
 
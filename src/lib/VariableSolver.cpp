@@ -2,7 +2,11 @@
 
 namespace crave {
 VariableSolver::VariableSolver(const VariableContainer& vcon, const ConstraintPartition& cp)
-    : var_ctn_(), constr_pttn_(cp), solver_(FactoryMetaSMT::getNewInstance()) {
+    : var_ctn_(),
+      constr_pttn_(cp),
+      frozen_variables_(vcon.frozen_variables),
+      solver_(FactoryMetaSMT::getNewInstance()),
+      model_(solver_) {
   for(VariableContainer::ReadRefPair const & pair : vcon.read_references) {
     if (constr_pttn_.containsVar(pair.first)) var_ctn_.read_references.push_back(pair);
   }
@@ -1,13 +1,51 @@
 #include "../crave/backend/VectorGenerator.hpp"
 #include "../crave/utils/Logging.hpp"
 
+#include <algorithm>
+#include <random>
 #include <string>
 
 namespace crave {
+
+extern RandomSeedManager rng;
+
+namespace {
+// resolves don't care bits of a value read from the solver and converts it to a constant
+Constant resolveValue(std::string* bits, unsigned width, bool sign) {
+  uint64_t value = 0;
+  for(char & c : *bits) {
+    if (c != '0' && c != '1') c = random_bit() ? '1' : '0';
+    value = (value << 1) | (c == '1');
+  }
+  return Constant(width < 64 ? value & (((uint64_t)1 << width) - 1) : value, width, sign);
+}
+}  // namespace
+
+unsigned VectorSolver::window_size = 128;
+
 VectorSolver::VectorSolver(int vector_id)
-    : constraints_(), vector_id_(vector_id), solver_(FactoryMetaSMT::getNewInstance()), vec_elements_() {}
+    : constraints_(),
+      vector_id_(vector_id),
+      solver_(FactoryMetaSMT::getNewInstance()),
+      vec_elements_(),
+      element_local_(true),
+      element_solver_(),
+      element_(),
+      element_idx_(),
+      bounded_offsets_(true),
+      min_offset_(0),
+      max_offset_(0) {}
 
-void VectorSolver::addConstraint(VectorConstraintPtr vc) { constraints_.push_back(vc); }
+void VectorSolver::addConstraint(VectorConstraintPtr vc) {
+  constraints_.push_back(vc);
+  element_local_ = element_local_ && vc->isElementLocal();
+  element_solver_.reset();
+  bounded_offsets_ = bounded_offsets_ && vc->hasBoundedOffsets();
+  if (!vc->indexOffsets().empty()) {
+    min_offset_ = std::min(min_offset_, *vc->indexOffsets().begin());
+    max_offset_ = std::max(max_offset_, *vc->indexOffsets().rbegin());
+  }
+}
 
 bool VectorSolver::solve(const VariableGenerator& var_gen) {
   std::string cstr_name_list;
@@ -24,10 +62,26 @@ bool VectorSolver::solve(const VariableGenerator& var_gen) {
   } else {
     LOG(INFO) << "Size of vector " << vector_id_ << " = " << size;
   }
-  resetSolver(size);
-  bool result = solver_->solve(false) || solver_->solve(true);
+  bool result;
+  if (element_local_) {
+    LOG(INFO) << "Solve vector " << vector_id_ << " elementwise";
+    result = solveElementwise(size, vector);
+  } else {
+    result = false;
+    if (bounded_offsets_ && window_size > 0 && size > window_size) {
+      LOG(INFO) << "Solve vector " << vector_id_ << " in windows of " << window_size << " elements";
+      result = solveWindowed(size, vector);
+      if (!result) {
+        LOG(INFO) << "Windowed solving of vector " << vector_id_ << " failed, solve whole vector";
+      }
+    }
+    if (!result) {
+      resetSolver(size);
+      result = solver_->solve(false) || solver_->solve(true);
+      if (result) solver_->readVector(vec_elements_, vector);
+    }
+  }
   if (result) {
-    solver_->readVector(vec_elements_, vector);
     LOG(INFO) << "Done solving vector " << vector_id_;
   }
   else {
@@ -79,6 +133,115 @@ void VectorSolver::buildSolver(unsigned int const size) {
   }
 }
 
+void VectorSolver::buildElementSolver() {
+  element_solver_.reset(FactoryMetaSMT::getNewInstance());
+  VectorElements element(1, new VariableExpr(new_var_id(), 1u, true));
+  element_idx_ = new VariableExpr(new_var_id(), placeholder_bitsize(), false);
+
+  for(VectorConstraintPtr constraint : constraints_) {
+    ReplaceVisitor replacer(&element);
+    replacer.setIdxVar(element_idx_);
+    constraint->expr()->visit(&replacer);
+    assert(replacer.okay());
+    if (constraint->isSoft())
+      element_solver_->makeSoftAssertion(*replacer.result());
+    else
+      element_solver_->makeAssertion(*replacer.result());
+  }
+  element_ = element[0];
+}
+
+bool VectorSolver::solveElementwise(unsigned int const size, __rand_vec_base* vector) {
+  if (!element_solver_) buildElementSolver();
+
+  uint64_t mask = element_->bitsize() < 64 ? ((uint64_t)1 << element_->bitsize()) - 1 : ~(uint64_t)0;
+  std::uniform_int_distribution<uint64_t> dist;
+  std::vector<std::string> values(size);
+  for (unsigned int i = 0; i < size; ++i) {
+    EqualOpr idx(element_idx_, new Constant(i, placeholder_bitsize(), false));
+    EqualOpr suggestion(element_, new Constant(dist(*rng.get()) & mask, element_->bitsize(), element_->sign()));
+    element_solver_->makeAssumption(idx);
+    element_solver_->makeSuggestion(suggestion);
+    if (!element_solver_->solve(false)) {
+      // soft constraints are dropped for this element only
+      element_solver_->makeAssumption(idx);
+      element_solver_->makeSuggestion(suggestion);
+      if (!element_solver_->solve(true)) return false;
+    }
+    element_solver_->read(*element_, values[i]);
+  }
+  vector->set_values(values);
+  return true;
+}
+
+bool VectorSolver::solveWindowed(unsigned int const size, __rand_vec_base* vector) {
+  int span = max_offset_ - min_offset_;
+  if (span >= static_cast<int>(window_size)) return false;
+
+  if (vec_elements_.size() != size) {
+    unsigned int old_size = vec_elements_.size();
+    vec_elements_.resize(size);
+    for (unsigned int i = old_size; i < size; ++i) {
+      vec_elements_[i] = new VariableExpr(new_var_id(), 1u, true);
+    }
+  }
+
+  std::vector<std::string> values(size);
+  for (unsigned int start = 0; start < size; start += window_size) {
+    unsigned int end = std::min(start + window_size, size);
+    solver_.reset(FactoryMetaSMT::getNewInstance());
+
+    // elements of the previous window that are accessed by a constraint instance of this window
+    int first = std::max(static_cast<int>(start) - span, 0);
+    std::vector<bool> accessed(start - first, false);
+
+    // every constraint instance belongs to the window that contains its highest accessed element
+    for(VectorConstraintPtr constraint : constraints_) {
+      int offset = constraint->indexOffsets().empty() ? 0 : *constraint->indexOffsets().rbegin();
+      int lo = std::max(static_cast<int>(start) - offset, 0);
+      int hi = std::min(static_cast<int>(end) - offset, static_cast<int>(size));
+      // instance i accesses the elements i + o
+      for(int o : constraint->indexOffsets()) {
+        int last = std::min(hi + o, static_cast<int>(start));
+        for (int j = std::max(lo + o, first); j < last; ++j) accessed[j - first] = true;
+      }
+      ReplaceVisitor replacer(&vec_elements_);
+      for (int i = lo; i < hi; ++i) {
+        replacer.setVecIdx(i);
+        constraint->expr()->visit(&replacer);
+
+        if (replacer.okay()) {
+          if (constraint->isSoft())
+            solver_->makeSoftAssertion(*replacer.result());
+          else
+            solver_->makeAssertion(*replacer.result());
+        }
+
+        replacer.reset();
+      }
+    }
+
+    std::vector<NodePtr> fixed;
+    for (int j = first; j < static_cast<int>(start); ++j) {
+      if (!accessed[j - first]) continue;
+      VariablePtr var = vec_elements_[j];
+      fixed.push_back(new EqualOpr(var, new Constant(resolveValue(&values[j], var->bitsize(), var->sign()))));
+    }
+
+    for(NodePtr const & n : fixed) solver_->makeAssumption(*n);
+    if (!solver_->solve(false)) {
+      for(NodePtr const & n : fixed) solver_->makeAssumption(*n);
+      if (!solver_->solve(true)) return false;
+    }
+
+    for (unsigned int j = start; j < end; ++j) {
+      if (!solver_->read(*vec_elements_[j], values[j])) return false;
+    }
+  }
+  vector->set_values(values);
+  return true;
+}
+
 VectorGenerator::VectorGenerator() : vector_solvers_() {}
 
 bool VectorGenerator::solve(const VariableGenerator& var_gen, const std::set<int>& vec_ids) {
@@ -9,26 +9,43 @@ namespace crave {
   void crv_constraint_base::activate() {
     if (!active_) {
       active_ = true;
-      request_rebuild();
+      request_toggle(*this);
     }
   }
 
   void crv_constraint_base::deactivate() {
     if (active_) {
       active_ = false;
-      request_rebuild();
+      request_toggle(*this);
     }
   }
 
   bool crv_constraint_base::active() const { return active_; }
 
   void crv_constraint_base::recursive_build(Generator &gen) const {
-    if (!active()) return;
     unsigned cnt = 0;
     if (!soft()) {
       for (auto e : expr_list()) gen(fullname() + "#" + std::to_string(cnt++), e);
     } else {
       for (auto e : expr_list()) gen.soft(fullname() + "#" + std::to_string(cnt++), e);
     }
+    // inactive constraints are added disabled, so toggling them later keeps the Generator
+    if (!active()) update_activation(gen);
+  }
+
+  void crv_constraint_base::update_activation(Generator &gen) const {
+    unsigned cnt = 0;
+    for (auto it = expr_list().begin(); it != expr_list().end(); ++it) {
+      std::string name = fullname() + "#" + std::to_string(cnt++);
+      if (active())
+        gen.enableConstraint(name);
+      else
+        gen.disableConstraint(name);
+    }
+  }
+
+  bool crv_constraint_base::recursive_collect(std::vector<crv_constraint_base const*>* constraints) const {
+    if (active()) constraints->push_back(this);
+    return true;
   }
 }
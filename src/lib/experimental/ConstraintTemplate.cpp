@@ -0,0 +1,226 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#include "../../crave/experimental/ConstraintTemplate.hpp"
+#include "../../crave/experimental/ConstraintBase.hpp"
+#include "../../crave/experimental/ExpressionKey.hpp"
+#include "../../crave/backend/Generator.hpp"
+#include "../../crave/frontend/Variable.hpp"
+#include "../../crave/ir/visitor/TerminalReplaceVisitor.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace crave {
+
+namespace {
+
+// templates of live instances are kept, entries of released templates are dropped when the registry is full
+const unsigned max_templates = 64;
+
+enum slot_kind { PLAIN_SLOT, WRITE_SLOT, READ_SLOT, DIST_SLOT };
+
+/**
+ * Lookup of the references in the global variable container by variable id. The container only appends, so the
+ * index catches up with the entries added since the last call. Only released templates remove entries, which
+ * clears the index.
+ */
+struct reference_index {
+  reference_index() : writes(), reads(), dists(), writes_seen(0), reads_seen(0), dists_seen(0) {}
+
+  void clear() { *this = reference_index(); }
+
+  void update(VariableContainer const& vc) {
+    for (; writes_seen < vc.write_references.size(); ++writes_seen)
+      writes[vc.write_references[writes_seen].first] = vc.write_references[writes_seen].second.get();
+    for (; reads_seen < vc.read_references.size(); ++reads_seen)
+      reads[vc.read_references[reads_seen].first] = vc.read_references[reads_seen].second.get();
+    for (; dists_seen < vc.dist_references.size(); ++dists_seen)
+      dists[vc.dist_references[dists_seen].first] = vc.dist_references[dists_seen].second.get();
+  }
+
+  std::unordered_map<int, AssignResult*> writes;
+  std::unordered_map<int, ReferenceExpression*> reads;
+  std::unordered_map<int, ReferenceExpression*> dists;
+  unsigned writes_seen;
+  unsigned reads_seen;
+  unsigned dists_seen;
+};
+
+reference_index& references() {
+  static reference_index refs;
+  return refs;
+}
+
+template <typename Pair>
+void erase_slots(std::vector<Pair>* refs, std::set<int> const& ids) {
+  refs->erase(std::remove_if(refs->begin(), refs->end(), [&ids](Pair const& p) { return ids.count(p.first) > 0; }),
+              refs->end());
+}
+
+}  // namespace
+
+struct crv_constraint_template::write_slot : AssignResult {
+  explicit write_slot(int i) : id(i), target() {}
+  void set_value(std::string const& result) override { target->set_value(result); }
+  Constant to_constant(std::string const& result) const override { return target->to_constant(result); }
+  Constant value_as_constant() const override { return target->value_as_constant(); }
+
+  int id;
+  AssignResult* target;
+};
+
+struct crv_constraint_template::reference_slot : ReferenceExpression {
+  explicit reference_slot(NodePtr v) : var(v), target() {}
+
+  // read and distribution references both constrain their variable to a constant
+  result_type expr() const override {
+    result_type e = target->expr();
+    assert(dynamic_cast<EqualOpr const*>(e.get()));
+    return new EqualOpr(var, static_cast<EqualOpr const&>(*e).rhs());
+  }
+
+  NodePtr var;
+  ReferenceExpression* target;
+};
+
+bool crv_constraint_template::instance::next() {
+  // a slot is frozen while the variable of the instance is
+  std::set<int>& frozen = variable_container()->frozen_variables;
+  for (unsigned i = 0; i < writes_.size(); ++i) {
+    write_slot& slot = *template_->write_slots_[i];
+    slot.target = writes_[i];
+    if (frozen.count(write_ids_[i]))
+      frozen.insert(slot.id);
+    else
+      frozen.erase(slot.id);
+  }
+  for (unsigned i = 0; i < references_.size(); ++i) template_->reference_slots_[i]->target = references_[i];
+  bool result = template_->gen_->nextCov();
+  // the variables of this instance may go away before the next one is randomized
+  for (auto& slot : template_->write_slots_) slot->target = nullptr;
+  for (auto& slot : template_->reference_slots_) slot->target = nullptr;
+  return result;
+}
+
+crv_constraint_template::~crv_constraint_template() {
+  VariableContainer& vc = *variable_container();
+  std::set<int> ids(slot_ids_.begin(), slot_ids_.end());
+  erase_slots(&vc.write_references, ids);
+  erase_slots(&vc.read_references, ids);
+  erase_slots(&vc.dist_references, ids);
+  for (int id : ids) {
+    vc.variables.erase(id);
+    vc.dist_ref_to_var_map.erase(id);
+    vc.frozen_variables.erase(id);
+  }
+  references().clear();
+}
+
+std::shared_ptr<crv_constraint_template::instance> crv_constraint_template::bind(
+    std::vector<crv_constraint_base const*> const& constraints) {
+  static std::unordered_map<std::string, std::weak_ptr<crv_constraint_template> > templates;
+
+  crv_expression_key key(false, true);
+  for (crv_constraint_base const* c : constraints) {
+    key.append(c->soft());
+    for (auto e : c->expr_list())
+      if (!key.add(*boost::proto::value(e))) return nullptr;
+    key.append('\0');
+  }
+
+  VariableContainer& vc = *variable_container();
+  reference_index& refs = references();
+  refs.update(vc);
+  auto result = std::make_shared<instance>();
+  std::vector<slot_kind> kinds;
+  for (VariableExpr const* v : key.variables()) {
+    int id = v->id();
+    slot_kind kind = PLAIN_SLOT;
+    if (refs.writes.count(id)) {
+      kind = WRITE_SLOT;
+      result->writes_.push_back(refs.writes.at(id));
+      result->write_ids_.push_back(id);
+    } else if (refs.reads.count(id)) {
+      kind = READ_SLOT;
+      result->references_.push_back(refs.reads.at(id));
+    } else if (refs.dists.count(id)) {
+      // the distribution must belong to a variable of the same constraints
+      auto var = vc.dist_ref_to_var_map.find(id);
+      if (var == vc.dist_ref_to_var_map.end() || !key.contains(var->second)) return nullptr;
+      kind = DIST_SLOT;
+      key.append(key.index(var->second));
+      result->references_.push_back(refs.dists.at(id));
+    }
+    kinds.push_back(kind);
+    key.append(kind);
+  }
+
+  // constraints seen for the first time get no template, as objects with constraints of their own would only
+  // accumulate templates that are never shared
+  auto ite = templates.find(key.str());
+  if (ite == templates.end()) {
+    if (templates.size() >= max_templates) {
+      for (auto i = templates.begin(); i != templates.end();)
+        i = i->second.expired() ? templates.erase(i) : std::next(i);
+      if (templates.size() >= max_templates) return nullptr;
+    }
+    templates.insert(std::make_pair(key.str(), std::weak_ptr<crv_constraint_template>()));
+    return nullptr;
+  }
+  result->template_ = ite->second.lock();
+  if (!result->template_) {
+    std::shared_ptr<crv_constraint_template> t(new crv_constraint_template());
+
+    std::vector<NodePtr> vars;
+    std::vector<int> ids;
+    for (unsigned i = 0; i < kinds.size(); ++i) {
+      VariableExpr const* v = key.variables()[i];
+      int id = new_var_id();
+      NodePtr var(new VariableExpr(id, v->bitsize(), v->sign()));
+      vc.variables[id] = var;
+      vars.push_back(var);
+      ids.push_back(id);
+      if (kinds[i] == WRITE_SLOT) {
+        t->write_slots_.push_back(std::make_shared<write_slot>(id));
+        vc.write_references.push_back(std::make_pair(id, t->write_slots_.back()));
+      } else if (kinds[i] != PLAIN_SLOT) {
+        t->reference_slots_.push_back(std::make_shared<reference_slot>(var));
+        if (kinds[i] == READ_SLOT)
+          vc.read_references.push_back(std::make_pair(id, t->reference_slots_.back()));
+        else
+          vc.dist_references.push_back(std::make_pair(id, t->reference_slots_.back()));
+      }
+    }
+    t->slot_ids_ = ids;
+    // distributions refer to their variable, which may come later in the order of slots
+    for (unsigned i = 0; i < kinds.size(); ++i) {
+      if (kinds[i] != DIST_SLOT) continue;
+      vc.dist_ref_to_var_map[ids[i]] = ids[key.index(vc.dist_ref_to_var_map.at(key.variables()[i]->id()))];
+    }
+
+    TerminalReplaceVisitor rename(TerminalReplaceVisitor::constant_function(),
+                                  [&key, &vars](VariableExpr const& v) { return vars[key.index(v.id())]; });
+    t->gen_ = std::make_shared<Generator>();
+    for (crv_constraint_base const* c : constraints) {
+      unsigned cnt = 0;
+      for (auto e : c->expr_list()) {
+        auto expr = boost::proto::make_expr<boost::proto::tag::terminal, Constraint_Domain>(
+            rename.replace(*boost::proto::value(e)));
+        std::string name = c->fullname() + "#" + std::to_string(cnt++);
+        if (c->soft())
+          t->gen_->soft(name, expr);
+        else
+          (*t->gen_)(name, expr);
+      }
+    }
+    ite->second = t;
+    result->template_ = t;
+  }
+  return result;
+}
+
+}  // end namespace crave
@@ -0,0 +1,91 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#include "../../crave/experimental/CoverageBins.hpp"
+
+#include <algorithm>
+
+namespace crave {
+
+namespace {
+
+bool anyInRange(uint64_t const* block, unsigned lo, unsigned hi) {
+  for (unsigned w = lo / 64; w <= hi / 64; ++w) {
+    uint64_t mask = ~0ULL;
+    if (w == lo / 64) mask &= ~0ULL << (lo % 64);
+    if (w == hi / 64 && hi % 64 != 63) mask &= (1ULL << (hi % 64 + 1)) - 1;
+    if (block[w] & mask) return true;
+  }
+  return false;
+}
+
+bool any(uint64_t const* block, unsigned words) {
+  for (unsigned w = 0; w < words; ++w)
+    if (block[w]) return true;
+  return false;
+}
+
+}  // namespace
+
+void crv_transition_bin::compile() {
+  unsigned words = 0;
+  for (crv_transition_fsm_state* s = root.get(); s; s = s->succ.get()) {
+    nfa_state st;
+    st.expr = s->expr;
+    st.min = std::max(s->minHit, 1);
+    st.max = std::max(s->maxHit, s->minHit);
+    st.first_word = words;
+    st.words = (st.max + 63) / 64;
+    st.last_mask = st.max % 64 ? (1ULL << (st.max % 64)) - 1 : ~0ULL;
+    st.succ = s->succ ? states_.size() + 1 : -1;
+    st.keep_on_fail = s->type != crv_transition_fsm_state::CONSEC;
+    st.guard = s->prev && s->prev->type == crv_transition_fsm_state::NON_CONSEC ? states_.size() - 1 : -1;
+    states_.push_back(st);
+    words += st.words;
+  }
+  active_.assign(words, 0);
+  next_.assign(words, 0);
+  predicates_.assign(states_.size(), -1);
+}
+
+bool crv_transition_bin::predicate(unsigned state, Evaluator &eval_) {
+  if (predicates_[state] < 0) predicates_[state] = eval_.evaluate(states_[state].expr) && eval_.result<bool>();
+  return predicates_[state];
+}
+
+void crv_transition_bin::calcHit(Evaluator &eval_) {
+  if (states_.empty()) compile();
+  std::fill(predicates_.begin(), predicates_.end(), -1);
+  std::fill(next_.begin(), next_.end(), 0);
+
+  // a new transition starts on every hit of the first state
+  if (predicate(0, eval_)) active_[0] |= 1;
+
+  bool hit = false;
+  for (unsigned s = 0; s < states_.size(); ++s) {
+    nfa_state const &st = states_[s];
+    uint64_t const *cur = &active_[st.first_word];
+    uint64_t *nxt = &next_[st.first_word];
+    if (!any(cur, st.words)) continue;
+
+    if (predicate(s, eval_)) {
+      // every count reaching the minimum continues at the successor or completes the transition
+      if (anyInRange(cur, st.min - 1, st.max - 1)) {
+        if (st.succ < 0)
+          hit = true;
+        else
+          next_[states_[st.succ].first_word] |= 1;
+      }
+      // counts below the maximum stay in the state
+      for (unsigned w = st.words; w-- > 0;) nxt[w] |= (cur[w] << 1) | (w > 0 ? cur[w - 1] >> 63 : 0);
+      nxt[st.words - 1] &= st.last_mask;
+    } else if (st.keep_on_fail || (st.guard >= 0 && !predicate(st.guard, eval_))) {
+      for (unsigned w = 0; w < st.words; ++w) nxt[w] |= cur[w];
+    }
+  }
+
+  // register only one hit per sample
+  if (hit) incrementHit();
+  active_.swap(next_);
+}
+
+}  // end namespace crave
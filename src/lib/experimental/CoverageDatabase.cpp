@@ -0,0 +1,155 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#include "../../crave/experimental/CoverageDatabase.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace crave {
+
+namespace {
+
+const char magic[8] = {'C', 'R', 'V', 'C', 'O', 'V', 'D', 'B'};
+const uint32_t version = 1;
+
+struct file_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t records;
+};
+
+struct record_entry {
+  uint64_t name_offset;
+  uint64_t name_length;
+  uint64_t bins;
+  uint64_t hits_offset;  // array of (bin index, hits) pairs
+  uint64_t hits_count;
+};
+
+uint64_t saturated_add(uint64_t a, uint64_t b) {
+  return a > std::numeric_limits<uint64_t>::max() - b ? std::numeric_limits<uint64_t>::max() : a + b;
+}
+
+uint64_t align(uint64_t offset) { return (offset + 7) & ~uint64_t(7); }
+
+}  // namespace
+
+void crv_coverage_db::add(std::string const& name, uint64_t bins, hit_list const& hits) {
+  record& r = records_[name];
+  r.bins = std::max(r.bins, bins);
+  if (hits.empty()) return;
+
+  hit_list merged;
+  merged.reserve(r.hits.size() + hits.size());
+  unsigned i = 0, j = 0;
+  while (i < r.hits.size() || j < hits.size()) {
+    if (j == hits.size() || (i < r.hits.size() && r.hits[i].first < hits[j].first)) {
+      merged.push_back(r.hits[i++]);
+    } else if (i == r.hits.size() || hits[j].first < r.hits[i].first) {
+      merged.push_back(hits[j++]);
+    } else {
+      merged.push_back(std::make_pair(r.hits[i].first, saturated_add(r.hits[i].second, hits[j].second)));
+      ++i;
+      ++j;
+    }
+  }
+  r.hits.swap(merged);
+}
+
+crv_coverage_db::record const* crv_coverage_db::find(std::string const& name) const {
+  std::map<std::string, record>::const_iterator ite = records_.find(name);
+  return ite != records_.end() ? &ite->second : NULL;
+}
+
+void crv_coverage_db::merge(crv_coverage_db const& other) {
+  for (auto const& r : other.records_) add(r.first, r.second.bins, r.second.hits);
+}
+
+bool crv_coverage_db::write(std::string const& filename) const {
+  std::vector<record_entry> table(records_.size());
+  uint64_t offset = sizeof(file_header) + table.size() * sizeof(record_entry);
+  unsigned k = 0;
+  for (auto const& r : records_) {
+    table[k].name_offset = offset;
+    table[k].name_length = r.first.size();
+    offset += r.first.size();
+    ++k;
+  }
+  offset = align(offset);
+  k = 0;
+  for (auto const& r : records_) {
+    table[k].bins = r.second.bins;
+    table[k].hits_offset = offset;
+    table[k].hits_count = r.second.hits.size();
+    offset += r.second.hits.size() * 2 * sizeof(uint64_t);
+    ++k;
+  }
+
+  std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+  if (!out) return false;
+  file_header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.records = records_.size();
+  out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  out.write(reinterpret_cast<char const*>(table.data()), table.size() * sizeof(record_entry));
+  uint64_t names = 0;
+  for (auto const& r : records_) {
+    out.write(r.first.data(), r.first.size());
+    names += r.first.size();
+  }
+  uint64_t start = sizeof(file_header) + table.size() * sizeof(record_entry) + names;
+  char const padding[8] = {0};
+  out.write(padding, align(start) - start);
+  for (auto const& r : records_) {
+    for (std::pair<uint64_t, uint64_t> const& h : r.second.hits) {
+      uint64_t pair[2] = {h.first, h.second};
+      out.write(reinterpret_cast<char const*>(pair), sizeof(pair));
+    }
+  }
+  return static_cast<bool>(out);
+}
+
+bool crv_coverage_db::read(std::string const& filename) {
+  std::ifstream in(filename.c_str(), std::ios::binary | std::ios::ate);
+  if (!in) return false;
+  uint64_t size = in.tellg();
+  if (size < sizeof(file_header)) return false;
+
+  // uint64_t storage keeps the contents aligned as if the file was mapped
+  std::vector<uint64_t> buffer((size + 7) / 8);
+  char const* data = reinterpret_cast<char const*>(buffer.data());
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char*>(buffer.data()), size)) return false;
+
+  file_header const* header = reinterpret_cast<file_header const*>(data);
+  if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version) return false;
+  if (sizeof(file_header) + uint64_t(header->records) * sizeof(record_entry) > size) return false;
+
+  record_entry const* table = reinterpret_cast<record_entry const*>(data + sizeof(file_header));
+  for (uint32_t k = 0; k < header->records; ++k) {
+    record_entry const& e = table[k];
+    if (e.name_offset + e.name_length > size || e.hits_offset % 8 ||
+        e.hits_count > (size - std::min(size, e.hits_offset)) / (2 * sizeof(uint64_t)))
+      return false;
+  }
+  for (uint32_t k = 0; k < header->records; ++k) {
+    record_entry const& e = table[k];
+    uint64_t const* pairs = reinterpret_cast<uint64_t const*>(data + e.hits_offset);
+    hit_list hits(e.hits_count);
+    for (uint64_t i = 0; i < e.hits_count; ++i) hits[i] = std::make_pair(pairs[2 * i], pairs[2 * i + 1]);
+    add(std::string(data + e.name_offset, e.name_length), e.bins, hits);
+  }
+  return true;
+}
+
+bool crv_coverage_db::merge_files(std::vector<std::string> const& inputs, std::string const& output) {
+  crv_coverage_db db;
+  for (std::string const& file : inputs)
+    if (!db.read(file)) return false;
+  return db.write(output);
+}
+
+}  // end namespace crave
@@ -0,0 +1,279 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#include "../../crave/experimental/CoverageIndex.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace crave {
+
+namespace {
+
+typedef std::vector<std::pair<uint64_t, uint64_t> > interval_list;  // closed, sorted and disjoint
+
+const uint64_t max_value = std::numeric_limits<uint64_t>::max();
+
+// a bin spanning more segments is cheaper to evaluate than to list in all of them
+const unsigned max_segments_per_bin = 64;
+
+interval_list normalize(interval_list l) {
+  std::sort(l.begin(), l.end());
+  interval_list result;
+  for (std::pair<uint64_t, uint64_t> const& i : l) {
+    if (!result.empty() && (result.back().second == max_value || i.first <= result.back().second + 1))
+      result.back().second = std::max(result.back().second, i.second);
+    else
+      result.push_back(i);
+  }
+  return result;
+}
+
+interval_list unite(interval_list const& a, interval_list const& b) {
+  interval_list result(a);
+  result.insert(result.end(), b.begin(), b.end());
+  return normalize(result);
+}
+
+interval_list intersect(interval_list const& a, interval_list const& b) {
+  interval_list result;
+  unsigned i = 0, j = 0;
+  while (i < a.size() && j < b.size()) {
+    uint64_t lo = std::max(a[i].first, b[j].first);
+    uint64_t hi = std::min(a[i].second, b[j].second);
+    if (lo <= hi) result.push_back(std::make_pair(lo, hi));
+    if (a[i].second < b[j].second)
+      ++i;
+    else
+      ++j;
+  }
+  return result;
+}
+
+interval_list complement(interval_list const& a) {
+  interval_list result;
+  uint64_t next = 0;
+  bool done = false;
+  for (std::pair<uint64_t, uint64_t> const& i : a) {
+    if (i.first > next) result.push_back(std::make_pair(next, i.first - 1));
+    if (i.second == max_value)
+      done = true;
+    else
+      next = i.second + 1;
+  }
+  if (!done) result.push_back(std::make_pair(next, max_value));
+  return result;
+}
+
+enum comparison { EQ, NE, LT, LE, GT, GE };
+
+interval_list compare(comparison cmp, uint64_t c) {
+  interval_list result;
+  switch (cmp) {
+    case EQ:
+      result.push_back(std::make_pair(c, c));
+      break;
+    case NE:
+      result = complement(compare(EQ, c));
+      break;
+    case LT:
+      if (c > 0) result.push_back(std::make_pair(0, c - 1));
+      break;
+    case LE:
+      result.push_back(std::make_pair(0, c));
+      break;
+    case GT:
+      if (c < max_value) result.push_back(std::make_pair(c + 1, max_value));
+      break;
+    case GE:
+      result.push_back(std::make_pair(c, max_value));
+      break;
+  }
+  return result;
+}
+
+bool comparisonOf(Node const& n, comparison* cmp) {
+  if (dynamic_cast<EqualOpr const*>(&n)) *cmp = EQ;
+  else if (dynamic_cast<NotEqualOpr const*>(&n)) *cmp = NE;
+  else if (dynamic_cast<LessOpr const*>(&n)) *cmp = LT;
+  else if (dynamic_cast<LessEqualOpr const*>(&n)) *cmp = LE;
+  else if (dynamic_cast<GreaterOpr const*>(&n)) *cmp = GT;
+  else if (dynamic_cast<GreaterEqualOpr const*>(&n)) *cmp = GE;
+  else return false;
+  return true;
+}
+
+comparison mirror(comparison cmp) {
+  switch (cmp) {
+    case LT:
+      return GT;
+    case LE:
+      return GE;
+    case GT:
+      return LT;
+    case GE:
+      return LE;
+    default:
+      return cmp;
+  }
+}
+
+/**
+ * Converts a bin expression over a single variable into the set of values for which it evaluates to true. The
+ * comparisons are unsigned on 64 bit, exactly as done by the Evaluator.
+ */
+struct interval_extractor {
+  interval_extractor() : known(false), var(0) {}
+
+  bool use(VariableExpr const& v) {
+    if (known) return v.id() == var;
+    known = true;
+    var = v.id();
+    return true;
+  }
+
+  bool insideValues(Inside const& in, interval_list* out) {
+    for (Inside::range_list::value_type const& r : in.ranges())
+      out->push_back(std::make_pair(r.first.value(), r.second.value()));
+    *out = normalize(*out);
+    return true;
+  }
+
+  bool run(Node const& n, interval_list* out) {
+    if (LogicalAndOpr const* a = dynamic_cast<LogicalAndOpr const*>(&n)) {
+      // inside(x, c) is built as (x == tmp) && inside(tmp, c)
+      EqualOpr const* eq = dynamic_cast<EqualOpr const*>(a->lhs().get());
+      Inside const* in = dynamic_cast<Inside const*>(a->rhs().get());
+      if (eq && in) {
+        VariableExpr const* x = dynamic_cast<VariableExpr const*>(eq->lhs().get());
+        VariableExpr const* tmp = dynamic_cast<VariableExpr const*>(eq->rhs().get());
+        VariableExpr const* in_var = dynamic_cast<VariableExpr const*>(in->child().get());
+        if (x && tmp && in_var && tmp->id() == in_var->id()) return use(*x) && insideValues(*in, out);
+      }
+      interval_list lhs, rhs;
+      if (!run(*a->lhs(), &lhs) || !run(*a->rhs(), &rhs)) return false;
+      *out = intersect(lhs, rhs);
+      return true;
+    }
+    if (LogicalOrOpr const* o = dynamic_cast<LogicalOrOpr const*>(&n)) {
+      interval_list lhs, rhs;
+      if (!run(*o->lhs(), &lhs) || !run(*o->rhs(), &rhs)) return false;
+      *out = unite(lhs, rhs);
+      return true;
+    }
+    if (NotOpr const* no = dynamic_cast<NotOpr const*>(&n)) {
+      interval_list child;
+      if (!run(*no->child(), &child)) return false;
+      *out = complement(child);
+      return true;
+    }
+    if (Inside const* in = dynamic_cast<Inside const*>(&n)) {
+      VariableExpr const* v = dynamic_cast<VariableExpr const*>(in->child().get());
+      return v && use(*v) && insideValues(*in, out);
+    }
+    comparison cmp;
+    BinaryExpression const* b = dynamic_cast<BinaryExpression const*>(&n);
+    if (!b || !comparisonOf(n, &cmp)) return false;
+    VariableExpr const* v = dynamic_cast<VariableExpr const*>(b->lhs().get());
+    Constant const* c = dynamic_cast<Constant const*>(b->rhs().get());
+    if (!v || !c) {
+      v = dynamic_cast<VariableExpr const*>(b->rhs().get());
+      c = dynamic_cast<Constant const*>(b->lhs().get());
+      cmp = mirror(cmp);
+    }
+    if (!v || !c || !use(*v)) return false;
+    *out = compare(cmp, c->value());
+    return true;
+  }
+
+  bool known;
+  unsigned var;
+};
+
+}  // namespace
+
+void crv_bin_index::build(std::vector<crv_bin>& bins) {
+  tables_.clear();
+  general_bins_.clear();
+  bins_data_ = bins.data();
+  bins_size_ = bins.size();
+
+  std::map<unsigned, std::vector<std::pair<crv_bin*, interval_list> > > by_var;
+  for (crv_bin& cb : bins) {
+    interval_extractor ex;
+    interval_list values;
+    if (ex.run(*boost::proto::value(cb.bin_expr()), &values) && ex.known)
+      by_var[ex.var].push_back(std::make_pair(&cb, values));
+    else
+      general_bins_.push_back(&cb);
+  }
+
+  for (auto const& entry : by_var) {
+    table t;
+    t.var = entry.first;
+    t.starts.push_back(0);
+    for (auto const& bin : entry.second) {
+      for (std::pair<uint64_t, uint64_t> const& i : bin.second) {
+        t.starts.push_back(i.first);
+        if (i.second != max_value) t.starts.push_back(i.second + 1);
+      }
+    }
+    std::sort(t.starts.begin(), t.starts.end());
+    t.starts.erase(std::unique(t.starts.begin(), t.starts.end()), t.starts.end());
+
+    // segment range [first, last) of each interval
+    auto segments = [&t](std::pair<uint64_t, uint64_t> const& i) {
+      unsigned first = std::lower_bound(t.starts.begin(), t.starts.end(), i.first) - t.starts.begin();
+      unsigned last = i.second == max_value ? t.starts.size()
+                                            : std::lower_bound(t.starts.begin(), t.starts.end(), i.second + 1) -
+                                                  t.starts.begin();
+      return std::make_pair(first, last);
+    };
+
+    std::vector<unsigned> count(t.starts.size() + 1, 0);
+    std::vector<std::pair<crv_bin*, interval_list> const*> indexed;
+    for (auto const& bin : entry.second) {
+      unsigned spanned = 0;
+      for (std::pair<uint64_t, uint64_t> const& i : bin.second) {
+        std::pair<unsigned, unsigned> s = segments(i);
+        spanned += s.second - s.first;
+      }
+      if (spanned > max_segments_per_bin) {
+        general_bins_.push_back(bin.first);
+        continue;
+      }
+      indexed.push_back(&bin);
+      for (std::pair<uint64_t, uint64_t> const& i : bin.second) {
+        std::pair<unsigned, unsigned> s = segments(i);
+        for (unsigned k = s.first; k < s.second; ++k) ++count[k + 1];
+      }
+    }
+
+    t.offsets.resize(t.starts.size() + 1, 0);
+    for (unsigned k = 0; k < t.starts.size(); ++k) t.offsets[k + 1] = t.offsets[k] + count[k + 1];
+    t.bins.resize(t.offsets.back());
+    std::vector<unsigned> fill(t.offsets.begin(), t.offsets.end() - 1);
+    for (auto const* bin : indexed) {
+      for (std::pair<uint64_t, uint64_t> const& i : bin->second) {
+        std::pair<unsigned, unsigned> s = segments(i);
+        for (unsigned k = s.first; k < s.second; ++k) t.bins[fill[k]++] = bin->first;
+      }
+    }
+    tables_.push_back(t);
+  }
+}
+
+void crv_bin_index::calcHits(Evaluator const& eval, std::vector<unsigned>* hits) {
+  for (table const& t : tables_) {
+    Constant value;
+    if (!eval.assigned_value(t.var, &value)) continue;
+    unsigned segment = std::upper_bound(t.starts.begin(), t.starts.end(), value.value()) - t.starts.begin() - 1;
+    for (unsigned i = t.offsets[segment]; i < t.offsets[segment + 1]; ++i) {
+      t.bins[i]->incrementHit();
+      hits->push_back(t.bins[i] - bins_data_);
+    }
+  }
+}
+
+}  // end namespace crave
@@ -0,0 +1,88 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#include "../../crave/experimental/CoverageSampleQueue.hpp"
+
+namespace crave {
+
+// A thread only sleeps after it set its waiting flag and checked the ring again, and the other thread checks the
+// flag after it moved its index. Both use sequentially consistent accesses, so one of them sees the other and no
+// wakeup is lost.
+
+crv_sample_queue::crv_sample_queue(unsigned capacity, unsigned width, process_function process)
+    : slots_(),
+      mask_(),
+      process_(process),
+      head_(0),
+      tail_(0),
+      worker_waiting_(false),
+      sampler_waiting_(false),
+      stop_(false),
+      mutex_(),
+      not_empty_(),
+      not_full_(),
+      worker_() {
+  std::size_t size = 1;
+  while (size < capacity) size <<= 1;
+  slots_.assign(size, std::vector<Constant>(width));
+  mask_ = size - 1;
+  worker_ = std::thread(&crv_sample_queue::run, this);
+}
+
+crv_sample_queue::~crv_sample_queue() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  not_empty_.notify_one();
+  worker_.join();
+}
+
+std::vector<Constant>& crv_sample_queue::reserve() {
+  wait(mask_);
+  return slots_[tail_.load(std::memory_order_relaxed) & mask_];
+}
+
+void crv_sample_queue::commit() {
+  tail_.store(tail_.load(std::memory_order_relaxed) + 1);
+  if (worker_waiting_.load()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    not_empty_.notify_one();
+  }
+}
+
+void crv_sample_queue::flush() { wait(0); }
+
+void crv_sample_queue::wait(std::size_t max_pending) {
+  std::size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) <= max_pending) return;
+  std::unique_lock<std::mutex> lock(mutex_);
+  sampler_waiting_.store(true);
+  while (tail - head_.load() > max_pending) not_full_.wait(lock);
+  sampler_waiting_.store(false);
+}
+
+void crv_sample_queue::run() {
+  std::size_t head = head_.load(std::memory_order_relaxed);
+  while (true) {
+    std::size_t tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      worker_waiting_.store(true);
+      while (head == tail_.load() && !stop_) not_empty_.wait(lock);
+      worker_waiting_.store(false);
+      // the sampling thread stops the queue after its last commit
+      if (head == tail_.load()) return;
+      continue;
+    }
+    for (; head != tail; ++head) {
+      process_(slots_[head & mask_]);
+      head_.store(head + 1);
+      if (sampler_waiting_.load()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        not_full_.notify_one();
+      }
+    }
+  }
+}
+
+}  // end namespace crave
@@ -10,4 +10,10 @@ void crv_object::recursive_build(Generator& gen) const {
   for (crv_object* obj : children_) obj->recursive_build(gen);
 }
 
+bool crv_object::recursive_collect(std::vector<crv_constraint_base const*>* constraints) const {
+  for (crv_object* obj : children_)
+    if (!obj->recursive_collect(constraints)) return false;
+  return true;
+}
+
 };  // namespace crave
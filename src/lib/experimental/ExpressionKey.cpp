@@ -0,0 +1,84 @@
+// Copyright 2012-2017 The CRAVE developers, University of Bremen, Germany. All rights reserved.
+
+#include "../../crave/experimental/ExpressionKey.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace crave {
+
+namespace {
+
+// numbers the node types in order of appearance, unlike hash codes the numbers of different types never collide
+unsigned type_number(std::type_index type) {
+  static std::mutex mutex;
+  static std::unordered_map<std::type_index, unsigned> numbers;
+  std::lock_guard<std::mutex> lock(mutex);
+  unsigned next = numbers.size();
+  return numbers.insert(std::make_pair(type, next)).first->second;
+}
+
+}  // namespace
+
+bool crv_expression_key::is_lifted(Constant const& c) {
+  if (!c.sign()) return true;
+  return c.bitsize() == 8 || c.bitsize() == 16 || c.bitsize() == 32 || c.bitsize() == 64;
+}
+
+bool crv_expression_key::add(Node const& n) {
+  append(type_number(typeid(n)));
+  if (Constant const* c = dynamic_cast<Constant const*>(&n)) {
+    append(c->bitsize());
+    append(c->sign());
+    if (lift_constants_ && is_lifted(*c))
+      constants_.push_back(c);
+    else
+      append(c->value());
+    return true;
+  }
+  if (VariableExpr const* v = dynamic_cast<VariableExpr const*>(&n)) {
+    max_id_ = std::max(max_id_, v->id());
+    if (!canonical_variables_) {
+      append(v->id());
+      return true;
+    }
+    auto ite = index_.find(v->id());
+    if (ite == index_.end()) {
+      ite = index_.insert(std::make_pair(v->id(), variables_.size())).first;
+      variables_.push_back(v);
+      append(v->bitsize());
+      append(v->sign());
+    }
+    append(ite->second);
+    return true;
+  }
+  if (Inside const* i = dynamic_cast<Inside const*>(&n)) {
+    append(i->collection().size());
+    for (Constant const& c : i->collection()) append(c.value());
+  } else if (ExtendExpression const* e = dynamic_cast<ExtendExpression const*>(&n)) {
+    append(e->value());
+  } else if (Bitslice const* b = dynamic_cast<Bitslice const*>(&n)) {
+    append(b->r());
+    append(b->l());
+  }
+  if (dynamic_cast<Unique const*>(&n) || dynamic_cast<ForEach const*>(&n) || dynamic_cast<VectorAccess const*>(&n))
+    return false;
+  if (UnaryExpression const* u = dynamic_cast<UnaryExpression const*>(&n)) return add(*u->child());
+  if (BinaryExpression const* b = dynamic_cast<BinaryExpression const*>(&n)) return add(*b->lhs()) && add(*b->rhs());
+  if (TernaryExpression const* t = dynamic_cast<TernaryExpression const*>(&n))
+    return add(*t->a()) && add(*t->b()) && add(*t->c());
+  if (Reduction const* r = dynamic_cast<Reduction const*>(&n)) {
+    append(r->kind());
+    append(r->operands().size());
+    for (NodePtr const& op : r->operands())
+      if (!add(*op)) return false;
+    return true;
+  }
+  // placeholders and vectors
+  return false;
+}
+
+}  // end namespace crave
@@ -47,11 +47,15 @@ crv_object::crv_object() {
 }
 
 crv_object::~crv_object() {
+  detach();
+  crv_obj_map.erase(fullname_);
+}
+
+void crv_object::detach() {
   if (parent_) {
     parent_->remove_child(this);
     parent_ = nullptr;
   }
-  crv_obj_map.erase(fullname_);
 }
 
 void crv_object::print_object_hierarchy(int lvl) const {
@@ -2,26 +2,88 @@
 
 #include "../../crave/experimental/SequenceItem.hpp"
 #include "../../crave/backend/Generator.hpp"
+#include "../../crave/experimental/ConstraintBase.hpp"
+#include "../../crave/experimental/ConstraintTemplate.hpp"
+#include "../../crave/experimental/ExpressionKey.hpp"
+#include "../../crave/frontend/ReadReference.hpp"
+#include "../../crave/ir/visitor/TerminalReplaceVisitor.hpp"
+
+#include <vector>
 
 namespace crave
 {
-  crv_sequence_item::crv_sequence_item() : gen_(), built_(false), cloned_(false) {}
+  namespace {
+
+    unsigned const MAX_CACHED_GENERATORS = 64;
+
+    /**
+     * A constant bound to a cached Generator through a read reference.
+     */
+    struct parameter {
+      virtual ~parameter() {}
+      virtual void set(uint64_t value) = 0;
+      NodePtr node;
+    };
+
+    template <typename T>
+    struct typed_parameter : parameter {
+      explicit typed_parameter(unsigned width) : value() {
+        node = boost::proto::value(make_expression(reference(value)));
+        if (width < bitsize_traits<T>::value) node = new Bitslice(node, width - 1, 0);
+      }
+      void set(uint64_t v) override { value = static_cast<T>(v); }
+      T value;
+    };
+
+    parameter* make_parameter(Constant const& c) {
+      if (!c.sign()) return new typed_parameter<uint64_t>(c.bitsize());
+      switch (c.bitsize()) {
+        case 8:
+          return new typed_parameter<int8_t>(8);
+        case 16:
+          return new typed_parameter<int16_t>(16);
+        case 32:
+          return new typed_parameter<int32_t>(32);
+        default:
+          return new typed_parameter<int64_t>(64);
+      }
+    }
+
+  }  // namespace
+
+  struct crv_sequence_item::cached_generator {
+    std::shared_ptr<Generator> gen;
+    std::vector<std::unique_ptr<parameter> > params;
+  };
 
-  crv_sequence_item::crv_sequence_item(crv_sequence_item const & other) : crv_object(other), gen_(), built_(false), cloned_(true) {}
+  crv_sequence_item::crv_sequence_item() : gen_(), template_(), rand_with_last_id_(0), built_(false), cloned_(false) {}
+
+  crv_sequence_item::crv_sequence_item(crv_sequence_item const & other) : crv_object(other), gen_(), template_(), rand_with_last_id_(0), built_(false), cloned_(true) {}
 
   std::string crv_sequence_item::obj_kind() const { return "crv_sequence_item"; }
 
   bool crv_sequence_item::randomize() {
     assert(!cloned_ && "cloned crv_sequence_item cannot be randomized");
     if (!built_) {
-      gen_ = std::make_shared<Generator>();
-      recursive_build(*gen_);
+      std::vector<crv_constraint_base const*> constraints;
+      if (recursive_collect(&constraints)) template_ = crv_constraint_template::bind(constraints);
+      if (!template_) build_generator();
       built_ = true;
     }
+    if (template_) return template_->next();
     return gen_->nextCov();
   }
+
+  void crv_sequence_item::build_generator() {
+    template_.reset();
+    gen_ = std::make_shared<Generator>();
+    recursive_build(*gen_);
+    built_ = true;
+  }
   
   void crv_sequence_item::goal(crv_covergroup& group) {
+    // coverage goals are specific to this object, so it leaves a shared template
+    if (!gen_) build_generator();
     for (auto e : group.bound_var_expr_list()) (*gen_)(e);
     for (auto e : group.uncovered_as_list()) gen_->cover(e);
   }
@@ -29,15 +91,67 @@ namespace crave
   void crv_sequence_item::request_rebuild() {
     built_ = false;
     gen_.reset();
+    template_.reset();
+    rand_with_cache_.clear();
     crv_object::request_rebuild();
   }
 
+  void crv_sequence_item::request_toggle(crv_constraint_base const& c) {
+    // a template holds the active constraints only, bind to the one of the new selection instead
+    if (template_) {
+      template_.reset();
+      built_ = false;
+    }
+    if (gen_) c.update_activation(*gen_);
+    for (auto& entry : rand_with_cache_) c.update_activation(*entry.second->gen);
+    crv_object::request_toggle(c);
+  }
+
   bool crv_sequence_item::randomize_with_expr_list(const expression_list & list) {
     assert(!cloned_ && "cloned crv_sequence_item cannot be randomized");
-    // TODO Generator caching
-    rand_with_gen_ = std::make_shared<Generator>();
-    recursive_build(*rand_with_gen_);
-    for (auto e : list) (*rand_with_gen_)(e);
+    crv_expression_key key(true);
+    bool cacheable = true;
+    for (auto e : list) {
+      if (!key.add(*boost::proto::value(e))) {
+        cacheable = false;
+        break;
+      }
+      key.append('\0');
+    }
+    // variables created since the last call are likely temporaries with a fresh id in every call, caching them would
+    // only fill the cache with entries that never hit
+    if (key.max_id() > rand_with_last_id_) cacheable = false;
+    rand_with_last_id_ = new_var_id();
+    std::vector<Constant const*> const& constants = key.constants();
+
+    auto ite = cacheable ? rand_with_cache_.find(key.str()) : rand_with_cache_.end();
+    if (ite == rand_with_cache_.end() && (!cacheable || rand_with_cache_.size() >= MAX_CACHED_GENERATORS)) {
+      // not cacheable or the cache is full, build a Generator for this call only
+      rand_with_gen_ = std::make_shared<Generator>();
+      recursive_build(*rand_with_gen_);
+      for (auto e : list) (*rand_with_gen_)(e);
+      return rand_with_gen_->next();
+    }
+
+    if (ite == rand_with_cache_.end()) {
+      auto cached = std::make_shared<cached_generator>();
+      cached->gen = std::make_shared<Generator>();
+      recursive_build(*cached->gen);
+      TerminalReplaceVisitor visitor([&cached](Constant const& c) {
+        if (!crv_expression_key::is_lifted(c)) return NodePtr();
+        cached->params.emplace_back(make_parameter(c));
+        return cached->params.back()->node;
+      });
+      for (auto e : list)
+        (*cached->gen)(boost::proto::make_expr<boost::proto::tag::terminal, Constraint_Domain>(
+            visitor.replace(*boost::proto::value(e))));
+      assert(cached->params.size() == constants.size());
+      ite = rand_with_cache_.insert(std::make_pair(key.str(), cached)).first;
+    }
+
+    cached_generator& cached = *ite->second;
+    for (unsigned i = 0; i < constants.size(); ++i) cached.params[i]->set(constants[i]->value());
+    rand_with_gen_ = cached.gen;
     return rand_with_gen_->next();
   }
 
@@ -2,6 +2,7 @@
 
 #include "../crave/ir/visitor/metaSMTNodeVisitor.hpp"
 #include "../crave/backend/FactoryMetaSMT.hpp"
+#include "../crave/backend/LocalSearchSolver.hpp"
 #include "../crave/utils/Logging.hpp"
 #include "metaSMTNodeVisitorImpl.hpp"
 
@@ -74,6 +75,7 @@ DEFINE_SOLVER(crave::CUDD, metaSMT::BitBlast<crave::CUDD_Solver>);
 namespace crave {
 
 SolverTypes FactoryMetaSMT::solver_type_ = UNDEFINED_SOLVER;  // default solver
+SolverTypes FactoryMetaSMT::local_search_fallback_ = UNDEFINED_SOLVER;
 
 void FactoryMetaSMT::setSolverType(std::string const& type) {
   if (type == "Boolector")
@@ -90,6 +92,8 @@ void FactoryMetaSMT::setSolverType(std::string const& type) {
     solver_type_ = Z3;
   else if (type == "Cudd")
     solver_type_ = CUDD;
+  else if (type == "LocalSearch")
+    solver_type_ = LOCAL_SEARCH;
 }
 
 #define TRY_GET_SOLVER(solver)                                                        \
@@ -124,6 +128,17 @@ metaSMTVisitor* FactoryMetaSMT::getNewInstance(SolverTypes type) {
       TRY_GET_SOLVER(CVC4);
     case CUDD:
       TRY_GET_SOLVER(CUDD);
+    case LOCAL_SEARCH: {
+      if (local_search_fallback_ != UNDEFINED_SOLVER)
+        return new LocalSearchSolver(getNewInstance(local_search_fallback_));
+      // the search falls back to the solver that is selected if none is specified, which is picked once
+      SolverTypes selected = solver_type_;
+      solver_type_ = UNDEFINED_SOLVER;
+      metaSMTVisitor* complete = getNewInstance();
+      local_search_fallback_ = solver_type_;
+      solver_type_ = selected;
+      return new LocalSearchSolver(complete);
+    }
     default:  // UNDEFINED_SOLVER
       TRY_GET_SOLVER_WHEN_UNDEFINED(BOOLECTOR);
       TRY_GET_SOLVER_WHEN_UNDEFINED(SWORD);
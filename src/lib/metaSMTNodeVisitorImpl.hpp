@@ -70,6 +70,7 @@ class metaSMTVisitorImpl : public metaSMTVisitor {
   virtual void visitForEach(ForEach const &);
   virtual void visitUnique(Unique const &);
   virtual void visitBitslice(Bitslice const &);
+  virtual void visitReduction(Reduction const &);
 
   virtual void makeAssertion(Node const &);
   virtual void makeSoftAssertion(Node const &);
@@ -243,12 +244,26 @@ void metaSMTVisitorImpl<SolverType>::visitInside(Inside const &in) {
   stack_entry entry;
   pop(entry);
 
+  // one term per interval of consecutive values instead of one per value
   result_type result = evaluate(solver_, preds::False);
-  for(Constant c : in.collection()) {
-    stack_entry constExpr;
-    c.visit(this);
-    pop(constExpr);
-    result = evaluate(solver_, preds::Or(result, preds::equal(entry.first, constExpr.first)));
+  for (Inside::range_list::value_type const &r : in.ranges()) {
+    stack_entry left, right;
+    r.first.visit(this);
+    pop(left);
+    if (r.first.value() == r.second.value()) {
+      result = evaluate(solver_, preds::Or(result, preds::equal(entry.first, left.first)));
+      continue;
+    }
+    r.second.visit(this);
+    pop(right);
+    result_type in_range;
+    if (r.first.sign())
+      in_range = evaluate(solver_, preds::And(qf_bv::bvsle(left.first, entry.first),
+                                              qf_bv::bvsle(entry.first, right.first)));
+    else
+      in_range = evaluate(solver_, preds::And(qf_bv::bvule(left.first, entry.first),
+                                              qf_bv::bvule(entry.first, right.first)));
+    result = evaluate(solver_, preds::Or(result, in_range));
   }
 
   exprStack_.push(std::make_pair(result, false));
@@ -531,6 +546,46 @@ void metaSMTVisitorImpl<SolverType>::visitBitslice(Bitslice const &b) {
   exprStack_.push(std::make_pair(result, false));
 }
 
+template <typename SolverType>
+void metaSMTVisitorImpl<SolverType>::visitReduction(Reduction const &r) {
+  std::vector<stack_entry> entries;
+  for(NodePtr const & n : r.operands()) {
+    n->visit(this);
+    stack_entry entry;
+    pop(entry);
+    entries.push_back(entry);
+  }
+
+  // combine neighbouring operands level by level to get a balanced tree of logarithmic depth
+  while (entries.size() > 1) {
+    std::vector<stack_entry> next;
+    for (unsigned i = 0; i + 1 < entries.size(); i += 2) {
+      stack_entry const &fst = entries[i];
+      stack_entry const &snd = entries[i + 1];
+      result_type result;
+      switch (r.kind()) {
+        case Reduction::SUM:
+          result = evaluate(solver_, qf_bv::bvadd(fst.first, snd.first));
+          break;
+        case Reduction::AND:
+          result = evaluate(solver_, qf_bv::bvand(fst.first, snd.first));
+          break;
+        case Reduction::OR:
+          result = evaluate(solver_, qf_bv::bvor(fst.first, snd.first));
+          break;
+        case Reduction::XOR:
+          result = evaluate(solver_, qf_bv::bvxor(fst.first, snd.first));
+          break;
+      }
+      next.push_back(std::make_pair(result, fst.second || snd.second));
+    }
+    if (entries.size() % 2 == 1) next.push_back(entries.back());
+    entries.swap(next);
+  }
+
+  exprStack_.push(entries.front());
+}
+
 template <typename SolverType>
 void metaSMTVisitorImpl<SolverType>::visitVectorAccess(VectorAccess const &) {
   throw std::runtime_error("VectorAccess is not allowed in metaSMTNodeVisitor.");
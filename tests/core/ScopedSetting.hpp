@@ -0,0 +1,18 @@
+#pragma once
+
+// Changes a static tuning setting for the rest of a test case and restores it even if a requirement fails.
+template <typename T>
+class ScopedSetting {
+ public:
+  ScopedSetting(T& setting, T value) : setting_(setting), old_value_(setting) { setting_ = value; }
+  ~ScopedSetting() { setting_ = old_value_; }
+
+ private:
+  ScopedSetting(ScopedSetting const&);
+  ScopedSetting& operator=(ScopedSetting const&);
+
+  T& setting_;
+  T old_value_;
+};
+
+//  vim: ft=cpp:ts=2:sw=2:expandtab
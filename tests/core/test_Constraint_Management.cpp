@@ -6,6 +6,8 @@
 #include <boost/foreach.hpp>
 #include <boost/assign/list_of.hpp>
 
+#include "ScopedSetting.hpp"
+
 #include <set>
 #include <iostream>
 
@@ -456,6 +458,53 @@ BOOST_AUTO_TEST_CASE(hier_constr_t) {
   BOOST_REQUIRE(!it.next());
 }
 
+BOOST_AUTO_TEST_CASE(cover_with_reference) {
+  unsigned pivot = 10;
+  randv<unsigned> x(NULL);
+  Generator gen(x() <= reference(pivot));
+  for (unsigned i = 0; i < 40; ++i) gen.cover(x() == i);
+
+  std::set<unsigned> hit;
+  for (unsigned i = 0; i <= 10; ++i) {
+    BOOST_REQUIRE(gen.nextCov());
+    BOOST_REQUIRE(!gen.isCovered());
+    BOOST_REQUIRE(hit.insert(x).second);
+  }
+
+  // bins that were unreachable with the old value of pivot become coverable
+  pivot = 20;
+  for (unsigned i = 11; i <= 20; ++i) {
+    BOOST_REQUIRE(gen.nextCov());
+    BOOST_REQUIRE(!gen.isCovered());
+    BOOST_REQUIRE(hit.insert(x).second);
+  }
+  BOOST_REQUIRE_EQUAL(hit.size(), 21);
+  BOOST_REQUIRE_EQUAL(*hit.rbegin(), 20);
+
+  BOOST_REQUIRE(gen.nextCov());
+  BOOST_REQUIRE(gen.isCovered());
+}
+
+BOOST_AUTO_TEST_CASE(cover_multiple_bins) {
+  randv<unsigned> a(NULL), b(NULL);
+  Generator gen(a() < 4 && b() < 4 && a() != b());
+  for (unsigned i = 0; i < 4; ++i) {
+    gen.cover(a() == i);
+    gen.cover(b() == i);
+  }
+
+  ScopedSetting<bool> multiple_bins(VariableCoverageSolver::hit_multiple_bins, true);
+  std::set<unsigned> hit_a, hit_b;
+  for (unsigned i = 0; i < 4; ++i) {
+    BOOST_REQUIRE(gen.nextCov());
+    BOOST_REQUIRE(!gen.isCovered());
+    BOOST_REQUIRE(hit_a.insert(a).second);
+    BOOST_REQUIRE(hit_b.insert(b).second);
+  }
+  BOOST_REQUIRE(gen.nextCov());
+  BOOST_REQUIRE(gen.isCovered());
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // Context
 
 //  vim: ft=cpp:ts=2:sw=2:expandtab
@@ -2,6 +2,8 @@
 
 #include <boost/format.hpp>
 
+#include "ScopedSetting.hpp"
+
 #include <set>
 #include <iostream>
 
@@ -59,6 +61,120 @@ BOOST_AUTO_TEST_CASE(by_reference) {
   BOOST_REQUIRE_GT(b, 10);
 }
 
+BOOST_AUTO_TEST_CASE(lazy_solving) {
+  unsigned bv = 0, cv = 0;
+  Variable<unsigned> a;
+  ReadReference<unsigned> b(bv);
+  WriteReference<unsigned> c(&cv);
+
+  Generator gen(a == b && a < 10);
+  gen(c > 100 && c < 200);
+  gen.enable_lazy_solving();
+
+  for (bv = 0; bv < 10; ++bv) {
+    BOOST_REQUIRE(gen.next());
+    BOOST_REQUIRE_EQUAL(gen[a], bv);
+  }
+  // the partition of c is never read
+  BOOST_REQUIRE_EQUAL(cv, 0);
+  BOOST_REQUIRE(gen.materialize());
+  BOOST_REQUIRE(cv > 100 && cv < 200);
+
+  // the read reference is evaluated on access
+  BOOST_REQUIRE(gen.next());
+  BOOST_REQUIRE_THROW(gen[a], std::runtime_error);
+
+  gen.enable_lazy_solving(false);
+  BOOST_REQUIRE(!gen.next());
+}
+
+BOOST_AUTO_TEST_CASE(partition_bdd_sampling) {
+  ScopedSetting<unsigned> limit(VariableDefaultSolver::complexity_limit_for_partition_bdd, 100000);
+
+  Variable<unsigned char> a, b;
+  Variable<bool> c;
+
+  Generator gen(a + b == 20 && a < b);
+  gen(if_then_else(c, a < 5, a >= 5));
+
+  for (int i = 0; i < 50; ++i) {
+    BOOST_REQUIRE(gen.next());
+    BOOST_REQUIRE_EQUAL((gen[a] + gen[b]) % 256, 20);
+    BOOST_REQUIRE_LT(gen[a], gen[b]);
+    BOOST_REQUIRE_EQUAL(gen[c], gen[a] < 5);
+  }
+
+  // unsatisfiable partitions are still reported
+  Generator unsat(a < 5 && a > 10);
+  BOOST_REQUIRE(!unsat.next());
+}
+
+BOOST_AUTO_TEST_CASE(solution_table) {
+  unsigned char rv = 0;
+  Variable<unsigned char> a, b;
+  Variable<bool> c;
+  ReadReference<unsigned char> r(rv);
+
+  Generator gen(a < 6 && if_then_else(c, a < 2, a >= 4));
+  gen(b == r + 1 && b < 10);
+
+  // the table is built when the partition is solved the second time
+  unsigned long before = VariableDefaultSolver::solved_by_table;
+  BOOST_REQUIRE(gen.next());
+  BOOST_REQUIRE_EQUAL(VariableDefaultSolver::solved_by_table, before);
+  BOOST_REQUIRE(gen.next());
+  BOOST_REQUIRE_GT(VariableDefaultSolver::solved_by_table, before);
+
+  std::set<std::pair<unsigned, bool> > generated;
+  for (rv = 0; rv < 9; ++rv) {
+    for (int i = 0; i < 50; ++i) {
+      BOOST_REQUIRE(gen.next());
+      BOOST_REQUIRE_EQUAL(gen[b], rv + 1);
+      BOOST_REQUIRE(gen[c] ? gen[a] < 2 : gen[a] >= 4 && gen[a] < 6);
+      generated.insert(std::make_pair(gen[a], gen[c]));
+    }
+  }
+  // the solutions of a are picked from a table of all four solutions
+  BOOST_REQUIRE_EQUAL(generated.size(), 4);
+
+  rv = 9;
+  BOOST_REQUIRE(!gen.next());
+}
+
+BOOST_AUTO_TEST_CASE(rejection_sampling) {
+  unsigned rv = 0;
+  Variable<unsigned> addr, a, b;
+  Variable<int> s;
+  ReadReference<unsigned> r(rv);
+
+  Generator gen(addr % 64 != 0 && addr != r);
+  gen(a != b && (a & 0xFF) != 0);
+  gen(s != -1 && s % 4 != 3);
+  // mostly rejected candidates, the solver takes over
+  gen(addr >= 0xFFFFFF00u || addr < 16);
+
+  unsigned long sampled = VariableDefaultSolver::solved_by_sampling;
+  unsigned long dropped = VariableDefaultSolver::dropped_samplers;
+  std::set<unsigned> generated;
+  for (int i = 0; i < 200; ++i) {
+    rv = i;
+    BOOST_REQUIRE(gen.next());
+    BOOST_REQUIRE_NE(gen[addr] % 64, 0);
+    BOOST_REQUIRE_NE(gen[addr], rv);
+    BOOST_REQUIRE(gen[addr] >= 0xFFFFFF00u || gen[addr] < 16);
+    BOOST_REQUIRE_NE(gen[a], gen[b]);
+    BOOST_REQUIRE_NE(gen[a] & 0xFF, 0);
+    BOOST_REQUIRE_NE(gen[s], -1);
+    BOOST_REQUIRE_NE(gen[s] % 4, 3);
+    generated.insert(gen[a]);
+  }
+  // the values of a are drawn uniformly from 2^32 candidates
+  BOOST_REQUIRE_GT(generated.size(), 190);
+  // both loose partitions are sampled on every call, only the sampler of addr is dropped
+  BOOST_REQUIRE_GE(VariableDefaultSolver::solved_by_sampling - sampled, 400);
+  BOOST_REQUIRE_EQUAL(VariableDefaultSolver::dropped_samplers - dropped, 1);
+}
+
 // temporaly fix a variable to a certain value using the assign operator
 BOOST_AUTO_TEST_CASE(named_reference) {
   unsigned bv = 0;
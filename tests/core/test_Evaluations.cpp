@@ -588,4 +588,67 @@ BOOST_AUTO_TEST_CASE(equal_t3) {
   BOOST_REQUIRE(eval.result<bool>());
 }
 
+BOOST_AUTO_TEST_CASE(reevaluate_expression) {
+  Variable<unsigned int> a;
+  Variable<unsigned int> b;
+  Variable<unsigned int> c;
+  Evaluator eval;
+
+  std::set<unsigned> s{2, 4};
+  expression expr = make_expression(if_then_else(a < 6, b + 1 == c, (a % 3 == 0) && inside(b, s)));
+
+  BOOST_REQUIRE(!eval.evaluate(expr));
+
+  for (unsigned i = 0; i <= 12; ++i) {
+    for (unsigned j = 0; j < 6; ++j) {
+      eval.assign(a, i);
+      eval.assign(b, j);
+      eval.assign(c, 3u);
+
+      bool expected = i < 6 ? j + 1 == 3 : (i % 3 == 0) && (j == 2 || j == 4);
+      BOOST_REQUIRE(eval.evaluate(expr));
+      BOOST_REQUIRE_EQUAL(eval.result<bool>(), expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(batch_evaluation) {
+  Variable<unsigned int> a;
+  Variable<int> b;
+  Variable<unsigned int> c;
+  Evaluator eval;
+
+  std::set<unsigned> s{2, 4, 7};
+  expression expr = make_expression(if_then_else(a < 6, b % 3 == -1 || inside(a, s), b / (a - 6) > 0) &&
+                                    c != 5);
+
+  std::vector<uint64_t> as, bs;
+  for (unsigned i = 0; i < 64; ++i) {
+    as.push_back(i % 16);
+    bs.push_back(static_cast<uint64_t>(static_cast<int64_t>(i) - 32));
+  }
+  eval.assign(c, 3u);
+  eval.assign_batch(a.id(), 32, false, as.data(), 64);
+  eval.assign_batch(b.id(), 32, true, bs.data(), 64);
+  uint64_t batch = eval.evaluate_batch(expr, 64);
+
+  // the lanes match the evaluations of the single assignments, a division by zero is undefined
+  bool expected = false;
+  for (unsigned i = 0; i < 64; ++i) {
+    eval.assign(a, static_cast<unsigned>(as[i]));
+    eval.assign(b, static_cast<int>(bs[i]));
+    expected = eval.evaluate(expr) && eval.result<bool>();
+    BOOST_REQUIRE_EQUAL(((batch >> i) & 1) != 0, expected);
+  }
+  BOOST_REQUIRE_NE(batch, 0);
+  BOOST_REQUIRE_NE(batch, ~0ULL);
+  // single assignments replace the lanes
+  BOOST_REQUIRE_EQUAL(eval.evaluate_batch(expr, 64), expected ? ~0ULL : 0);
+
+  eval.assign(c, 5u);
+  eval.assign_batch(a.id(), 32, false, as.data(), 10);
+  eval.assign_batch(b.id(), 32, true, bs.data(), 10);
+  BOOST_REQUIRE_EQUAL(eval.evaluate_batch(expr, 10), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // Evaluations
@@ -0,0 +1,45 @@
+#include <boost/test/unit_test.hpp>
+
+#include <crave/backend/LocalSearchSolver.hpp>
+
+#include "ScopedSetting.hpp"
+
+using namespace crave;
+
+BOOST_FIXTURE_TEST_SUITE(LocalSearch_t, Context_Fixture)
+
+BOOST_AUTO_TEST_CASE(solved_by_search) {
+  // the solution tables and the rejection sampler would answer most solves before the search
+  ScopedSetting<unsigned> candidates(VariableDefaultSolver::rejection_sampling_candidates, 0);
+  ScopedSetting<unsigned> max_bits(VariableDefaultSolver::solution_table_max_bits, 0);
+
+  Variable<unsigned> a, b;
+  Variable<unsigned char> c;
+  Variable<unsigned short> d;
+  Variable<int> e;
+  Generator gen(a < b && b < 1000 && (a & 3) == 1);
+  gen(c > 200 && c != 250);
+  gen(d % 7 == 3 && d < 5000);
+  // signed orderings are not decided exactly by the evaluator, the complete solver solves them directly
+  gen(e > -50 && e < 50 && e != 0);
+
+  unsigned long before = LocalSearchSolver::solved_by_search;
+  for (int i = 0; i < 50; ++i) {
+    BOOST_REQUIRE(gen.next());
+    BOOST_REQUIRE_LT(gen[a], gen[b]);
+    BOOST_REQUIRE_LT(gen[b], 1000);
+    BOOST_REQUIRE_EQUAL(gen[a] & 3, 1);
+    BOOST_REQUIRE_GT(gen[c], 200);
+    BOOST_REQUIRE_NE(gen[c], 250);
+    BOOST_REQUIRE_EQUAL(gen[d] % 7, 3);
+    BOOST_REQUIRE_LT(gen[d], 5000);
+    BOOST_REQUIRE(gen[e] > -50 && gen[e] < 50 && gen[e] != 0);
+  }
+  // the search is stochastic and the complete solver takes over after a failed search, but the unsigned
+  // partitions are searchable
+  BOOST_REQUIRE_GT(LocalSearchSolver::solved_by_search, before);
+}
+
+BOOST_AUTO_TEST_SUITE_END()  // LocalSearch_t
+
+//  vim: ft=cpp:ts=2:sw=2:expandtab
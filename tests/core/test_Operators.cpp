@@ -187,6 +187,61 @@ BOOST_AUTO_TEST_CASE(greater_equal) {
   VariableDefaultSolver::bypass_constraint_analysis = false;
 }
 
+BOOST_AUTO_TEST_CASE(compare_wide_constants) {
+  Variable<unsigned char> a;
+  Variable<signed char> b;
+
+  Generator gen_a;
+  gen_a(a < 300u)(a >= 250u)(a != -1);
+
+  std::set<unsigned> generated_a;
+  for (unsigned iterations = 0; gen_a.next(); ++iterations) {
+    unsigned av = gen_a[a];
+    generated_a.insert(av);
+    gen_a(a != av);
+    BOOST_REQUIRE_LT(iterations, 300);
+  }
+  BOOST_REQUIRE_EQUAL(generated_a.size(), 6);
+  BOOST_REQUIRE_EQUAL(*generated_a.begin(), 250);
+
+  // constants outside of the range of a fold the comparison, the others are narrowed to the width of a
+  Context ctx(variable_container());
+  FixWidthVisitor fwv;
+  NodePtr less(fwv.fixWidth(*boost::proto::eval(a < 300u, ctx)));
+  Constant const* folded = dynamic_cast<Constant const*>(less.get());
+  BOOST_REQUIRE(folded);
+  BOOST_REQUIRE_EQUAL(folded->bitsize(), 1);
+  BOOST_REQUIRE_EQUAL(folded->value(), 1);
+  NodePtr greater_equal(fwv.fixWidth(*boost::proto::eval(a >= 250u, ctx)));
+  GreaterEqualOpr const* ge = dynamic_cast<GreaterEqualOpr const*>(greater_equal.get());
+  BOOST_REQUIRE(ge);
+  Constant const* narrowed = dynamic_cast<Constant const*>(ge->rhs().get());
+  BOOST_REQUIRE(narrowed);
+  BOOST_REQUIRE_EQUAL(narrowed->bitsize(), 8);
+  BOOST_REQUIRE_EQUAL(narrowed->value(), 250);
+
+  Generator gen_b;
+  gen_b(b > -1000)(b < -120)(b != 1000u);
+
+  std::set<int> generated_b;
+  for (unsigned iterations = 0; gen_b.next(); ++iterations) {
+    int bv = gen_b[b];
+    generated_b.insert(bv);
+    gen_b(b != bv);
+    BOOST_REQUIRE_LT(iterations, 300);
+  }
+  BOOST_REQUIRE_EQUAL(generated_b.size(), 8);
+  BOOST_REQUIRE_EQUAL(*generated_b.begin(), -128);
+
+  Generator unsat_a;
+  unsat_a(a > 300u);
+  BOOST_REQUIRE(!unsat_a.next());
+
+  Generator unsat_b;
+  unsat_b(b == 300u);
+  BOOST_REQUIRE(!unsat_b.next());
+}
+
 BOOST_AUTO_TEST_CASE(neg_t1) {
   Variable<int> a;
   Variable<int> b;
@@ -564,6 +619,42 @@ BOOST_AUTO_TEST_CASE(element_not_inside) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(element_inside_ranges) {
+  std::vector<int> v;
+  for (int i = -300; i < -100; ++i) v.push_back(i);
+  v.push_back(5);
+  v.push_back(7);
+  for (int i = 1000; i < 3000; ++i) v.push_back(i);
+  std::set<int> s(v.begin(), v.end());
+
+  std::set<Constant> constants;
+  for (int i : v) constants.insert(Constant(i, 32, true));
+  Inside in(new VariableExpr(0, 32, true), constants);
+  BOOST_REQUIRE_EQUAL(in.ranges().size(), 4);
+  BOOST_REQUIRE_EQUAL(static_cast<int>(in.ranges().back().first.value()), -300);
+  BOOST_REQUIRE_EQUAL(static_cast<int>(in.ranges().back().second.value()), -101);
+
+  Variable<int> x;
+
+  Generator gen;
+  gen(inside(x, v));
+  for (int i = 0; i < 100; ++i) {
+    BOOST_REQUIRE(gen.next());
+    BOOST_REQUIRE(s.count(gen[x]));
+  }
+
+  gen(x < 0 && x % 2 == 0);
+  for (int i = 0; i < 100; ++i) {
+    BOOST_REQUIRE(gen.next());
+    BOOST_REQUIRE(s.count(gen[x]));
+    BOOST_REQUIRE_LT(gen[x], 0);
+    BOOST_REQUIRE_EQUAL(gen[x] % 2, 0);
+  }
+
+  gen(x > -100);
+  BOOST_REQUIRE(!gen.next());
+}
+
 BOOST_AUTO_TEST_CASE(if_then_else_t1) {
   unsigned int a;
   Variable<unsigned int> b;
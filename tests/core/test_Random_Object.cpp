@@ -298,6 +298,145 @@ BOOST_AUTO_TEST_CASE(item_with_vector) {
   }
 }
 
+struct Item3 : public rand_obj {
+  Item3() : x(this), y(this) {
+    constraint(x() < y());
+    constraint(y() <= 100);
+  }
+
+  randv<int> x;
+  randv<int> y;
+};
+
+BOOST_AUTO_TEST_CASE(rand_mode_test) {
+  Item3 it;
+  it.y.rand_mode(false);
+  it.y = 10;
+  for (int i = 0; i < 10; i++) {
+    BOOST_REQUIRE(it.next());
+    BOOST_REQUIRE_EQUAL(it.y, 10);
+    BOOST_REQUIRE_LT(it.x, 10);
+  }
+
+  it.x.rand_mode(false);
+  it.x = 20;
+  BOOST_REQUIRE(!it.next());
+  it.x = 5;
+  BOOST_REQUIRE(it.next());
+  BOOST_REQUIRE_EQUAL(it.x, 5);
+
+  it.x.rand_mode(true);
+  it.y.rand_mode(true);
+  BOOST_REQUIRE(it.next());
+  BOOST_REQUIRE_LT(it.x, it.y);
+  BOOST_REQUIRE_LE(it.y, 100);
+}
+
+BOOST_AUTO_TEST_CASE(rand_mode_cover) {
+  randv<unsigned> a(NULL), b(NULL);
+  Generator gen(a() < 4 && b() < 4);
+  for (unsigned i = 0; i < 4; ++i) {
+    gen.cover(a() == i);
+    gen.cover(b() == i);
+  }
+
+  // the coverage solver keeps frozen variables, only b == 2 of the bins of b is reachable
+  b.rand_mode(false);
+  b = 2;
+  std::set<unsigned> hit_a;
+  for (unsigned i = 0; i < 5; ++i) {
+    BOOST_REQUIRE(gen.nextCov());
+    BOOST_REQUIRE(!gen.isCovered());
+    BOOST_REQUIRE_EQUAL(b, 2);
+    hit_a.insert(a);
+  }
+  BOOST_REQUIRE_EQUAL(hit_a.size(), 4);
+
+  b.rand_mode(true);
+  std::set<unsigned> hit_b;
+  for (unsigned i = 0; i < 3; ++i) {
+    BOOST_REQUIRE(gen.nextCov());
+    BOOST_REQUIRE(!gen.isCovered());
+    BOOST_REQUIRE(hit_b.insert(b).second);
+  }
+  BOOST_REQUIRE(!hit_b.count(2));
+  BOOST_REQUIRE(gen.nextCov());
+  BOOST_REQUIRE(gen.isCovered());
+}
+
+struct Item4 : public rand_obj {
+  Item4() : x(this), v(this) {
+    constraint(x() < 10);
+    constraint(v().size() == 5);
+    constraint(foreach (v(), v()[_i] < 100));
+  }
+
+  randv<unsigned> x;
+  rand_vec<unsigned> v;
+  placeholder _i;
+};
+
+BOOST_AUTO_TEST_CASE(rand_mode_vector) {
+  Item4 it;
+  it.x.rand_mode(false);
+  it.x = 7;
+  // vectors have no rand_mode, they are generated on every call
+  for (int i = 0; i < 5; i++) {
+    BOOST_REQUIRE(it.next());
+    BOOST_REQUIRE_EQUAL(it.x, 7);
+    BOOST_REQUIRE_EQUAL(it.v.size(), 5);
+    for (unsigned k = 0; k < it.v.size(); k++) BOOST_REQUIRE_LT(it.v[k], 100);
+    it.v[0] = 1000;
+  }
+}
+
+struct Packet : public rand_obj {
+  Packet() : hdr_len(this), payload_len(this), len(this), mode(this), crc_en(this), delta(this), neg(this) {
+    constraint(len() == hdr_len() + payload_len());
+    constraint(4 <= hdr_len() && hdr_len() <= 8);
+    constraint(payload_len() < 100);
+    constraint(len() % 4 == 0);
+    constraint(mode() < 4);
+    constraint(crc_en() == (mode() == 3));
+    constraint(-5 <= delta() && delta() <= 5);
+    constraint(neg() == -delta());
+  }
+
+  randv<unsigned short> hdr_len;
+  randv<unsigned short> payload_len;
+  randv<unsigned short> len;
+  randv<unsigned> mode;
+  randv<bool> crc_en;
+  randv<int> delta;
+  randv<int> neg;
+};
+
+BOOST_AUTO_TEST_CASE(defined_variables) {
+  Packet p;
+  for (int i = 0; i < 20; i++) {
+    BOOST_REQUIRE(p.next());
+    BOOST_REQUIRE_EQUAL(p.len, p.hdr_len + p.payload_len);
+    BOOST_REQUIRE_EQUAL(p.len % 4, 0);
+    BOOST_REQUIRE_EQUAL(p.crc_en, p.mode == 3);
+    BOOST_REQUIRE_EQUAL(p.neg, -p.delta);
+  }
+
+  p.len.rand_mode(false);
+  p.len = 40;
+  BOOST_REQUIRE(p.next());
+  BOOST_REQUIRE_EQUAL(p.hdr_len + p.payload_len, 40);
+  p.len = 42;
+  BOOST_REQUIRE(!p.next());
+  p.len.rand_mode(true);
+
+  randv<unsigned> a(NULL), b(NULL);
+  Variable<unsigned> sum;
+  Generator gen(sum == a() + b());
+  gen(a() < 10)(b() < 10);
+  BOOST_REQUIRE(gen.next());
+  BOOST_REQUIRE_EQUAL(gen[sum], a + b);
+}
+
 class Constraint_base : public Generator {
  public:
   Constraint_base() : Generator(), constraint(*this) {}
@@ -1,5 +1,7 @@
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
 #include <crave/ir/UserConstraint.hpp>
 #include <crave/ir/UserExpression.hpp>
 #include <crave/utils/Evaluator.hpp>
@@ -32,6 +34,45 @@ BOOST_AUTO_TEST_CASE(constraint_partitioning) {
   BOOST_REQUIRE_EQUAL(cp.getPartitions().size(), 2);
 }
 
+BOOST_AUTO_TEST_CASE(soft_cover_partitioning) {
+  randv<unsigned> a, b, c, d, e, f;
+  ConstraintPartitioner cp;
+  ConstraintManager cm;
+  Context ctx(variable_container());
+  cm.makeConstraint(a() > b(), &ctx);
+  cm.makeConstraint(c() > d(), &ctx);
+  cm.makeConstraint(a() == c(), &ctx, false, true);
+  cm.makeConstraint(f() == a(), &ctx, false, true);
+  cm.makeConstraint(b() != d(), &ctx, true);
+  cm.makeConstraint(e() < 3, &ctx, true);
+
+  cp.reset();
+  cp.mergeConstraints(cm);
+  cp.partition();
+
+  // the soft constraint merges, of the covers only the one with a variable of its own takes part, in a separate
+  // partition of that variable
+  BOOST_REQUIRE_EQUAL(cp.getPartitions().size(), 3);
+  for (ConstraintPartition const& part : cp.getPartitions()) {
+    if (part.containsVar(e().id())) continue;
+    if (part.containsVar(f().id())) {
+      BOOST_REQUIRE(!part.containsVar(a().id()));
+      BOOST_REQUIRE_EQUAL(std::count_if(part.begin(), part.end(), [](ConstraintPtr c) { return c->isCover(); }), 1);
+      continue;
+    }
+    BOOST_REQUIRE(part.containsVar(a().id()) && part.containsVar(c().id()));
+    BOOST_REQUIRE_EQUAL(std::count_if(part.begin(), part.end(), [](ConstraintPtr c) { return c->isCover(); }), 0);
+  }
+
+  // the coverage solvers get both covers, but only the soft constraint with a variable of its own
+  BOOST_REQUIRE_EQUAL(cp.getCoveragePartitions().size(), 2);
+  for (ConstraintPartition const& part : cp.getCoveragePartitions()) {
+    if (part.containsVar(e().id())) continue;
+    BOOST_REQUIRE_EQUAL(std::count_if(part.begin(), part.end(), [](ConstraintPtr c) { return c->isCover(); }), 2);
+    BOOST_REQUIRE_EQUAL(std::count_if(part.begin(), part.end(), [](ConstraintPtr c) { return c->isSoft(); }), 0);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(constraint_expression_mixing) {
   randv<unsigned> x, y, z, t;
   expression e1 = make_expression(x() + y());
@@ -2,6 +2,8 @@
 
 #include <boost/format.hpp>
 
+#include "ScopedSetting.hpp"
+
 #include <set>
 #include <iostream>
 
@@ -209,6 +211,56 @@ BOOST_AUTO_TEST_CASE(soft_vec_constraint) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(element_local_vec_constraint) {
+  rand_vec<unsigned char> v(NULL);
+  placeholder i;
+
+  Generator gen;
+  gen(v().size() == 20);
+  gen(foreach (v(), v()[i] < 100));
+  gen(foreach (v(), if_then(i % 5 == 3, v()[i] == i)));
+  gen.soft(foreach (v(), v()[i] == 7));
+  for (int j = 0; j < 5; j++) {
+    BOOST_REQUIRE(gen.next());
+    BOOST_REQUIRE_EQUAL(v.size(), 20);
+    for (unsigned k = 0; k < v.size(); k++) {
+      // the soft constraint is only dropped for the elements that contradict it
+      if (k % 5 == 3)
+        BOOST_REQUIRE_EQUAL(v[k], k);
+      else
+        BOOST_REQUIRE_EQUAL(v[k], 7);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(windowed_vec_constraint) {
+  rand_vec<unsigned int> v(NULL);
+  placeholder i;
+
+  Generator gen;
+  gen(v().size() == 1000);
+  gen(foreach (v(), v()[i] < v()[i + 1]));
+  gen(foreach (v(), v()[i] <= v()[i - 1] + 10));
+  gen(foreach (v(), v()[i] < 100000));
+  BOOST_REQUIRE(gen.next());
+  BOOST_REQUIRE_EQUAL(v.size(), 1000);
+  for (unsigned k = 1; k < v.size(); k++) {
+    BOOST_REQUIRE_LT(v[k - 1], v[k]);
+    BOOST_REQUIRE_LE(v[k], v[k - 1] + 10);
+  }
+
+  // windows that cannot be extended fall back to solving the whole vector
+  rand_vec<unsigned char> w(NULL);
+  ScopedSetting<unsigned> window_size(VectorSolver::window_size, 4);
+  Generator gen1;
+  gen1(w().size() == 20);
+  gen1(foreach (w(), w()[i] < w()[i + 1]));
+  gen1(foreach (w(), w()[i] < 20));
+  BOOST_REQUIRE(gen1.next());
+  BOOST_REQUIRE_EQUAL(w.size(), 20);
+  for (unsigned k = 0; k < w.size(); k++) BOOST_REQUIRE_EQUAL(w[k], k);
+}
+
 BOOST_AUTO_TEST_CASE(mixed_bv_width_1) {
   rand_vec<signed char> a(NULL);
   placeholder idx;
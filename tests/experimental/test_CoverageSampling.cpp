@@ -3,6 +3,8 @@
 #include <crave/experimental/Coverage.hpp>
 #include <crave/experimental/Variable.hpp>
 
+#include <cstdio>
+#include <set>
 #include <vector>
 
 using namespace crave;
@@ -197,6 +199,190 @@ BOOST_AUTO_TEST_CASE(ieee1800_2012_p530_covergroup_test) {
   BOOST_REQUIRE(cg.covered());
 }
 
+struct range_covergroup : public crv_covergroup {
+  crv_variable<unsigned> a;
+  crv_variable<unsigned> b;
+
+  crv_coverpoint cp1{"coverpoint1"};
+
+  range_covergroup(crv_object_name) {
+    for (unsigned i = 0; i < 64; i++) cp1.simple_bins().push_back(crv_bin(a() >= 16 * i && a() < 16 * (i + 1)));
+    std::set<unsigned> s{3, 5, 1000};
+    cp1.simple_bins().push_back(crv_bin(inside(a(), s)));
+    cp1.simple_bins().push_back(crv_bin(!(a() == 7)));
+    cp1.simple_bins().push_back(crv_bin(a() > 0));
+    cp1.simple_bins().push_back(crv_bin(a() + b() == 10));
+  }
+};
+
+BOOST_AUTO_TEST_CASE(indexed_range_bins_test) {
+  range_covergroup cg{"covergroup6"};
+
+  cg.b = 3;
+  for (unsigned i = 0; i < 1024; i++) {
+    cg.a = i;
+    cg.sample();
+  }
+
+  std::vector<crv_bin>& bins = cg.cp1.simple_bins();
+  for (unsigned i = 0; i < 64; i++) BOOST_REQUIRE_EQUAL(bins[i].hit_count(), 16);
+  BOOST_REQUIRE_EQUAL(bins[64].hit_count(), 3);
+  BOOST_REQUIRE_EQUAL(bins[65].hit_count(), 1023);
+  BOOST_REQUIRE_EQUAL(bins[66].hit_count(), 1023);
+  BOOST_REQUIRE_EQUAL(bins[67].hit_count(), 1);
+}
+
+struct cross_covergroup : public crv_covergroup {
+  crv_variable<unsigned> a;
+  crv_variable<unsigned> b;
+
+  crv_coverpoint cp1{"coverpoint1"};
+  crv_coverpoint cp2{"coverpoint2"};
+  crv_cross cross{"cross", cp1, cp2};
+
+  cross_covergroup(crv_object_name) {
+    for (unsigned i = 0; i < 16; i++) {
+      cp1.simple_bins().push_back(crv_bin(a() == i));
+      cp2.simple_bins().push_back(crv_bin(b() == i));
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(sparse_cross_test) {
+  cross_covergroup cg{"covergroup7"};
+
+  for (unsigned i = 0; i < 16; i++)
+    for (unsigned j = 0; j < 16; j++) {
+      if (i == 3 && j == 5) continue;
+      cg.a = i;
+      cg.b = j;
+      cg.sample();
+    }
+
+  BOOST_REQUIRE_EQUAL(cg.cross.size(), 256);
+  BOOST_REQUIRE_EQUAL(cg.cross.covered_count(), 255);
+  BOOST_REQUIRE_EQUAL(cg.cross.hit_count({3, 4}), 1);
+  BOOST_REQUIRE_EQUAL(cg.cross.hit_count({3, 5}), 0);
+  BOOST_REQUIRE(!cg.covered());
+  expression_list uncovered = cg.uncovered_as_list();
+  BOOST_REQUIRE_EQUAL(std::distance(uncovered.begin(), uncovered.end()), 1);
+
+  cg.a = 3;
+  cg.b = 5;
+  cg.sample();
+
+  BOOST_REQUIRE(cg.covered());
+}
+
+struct long_repetition_covergroup : public crv_covergroup {
+  crv_variable<unsigned> a;
+
+  crv_coverpoint cp1{"coverpoint1"};
+
+  long_repetition_covergroup(crv_object_name) {
+    // b0 = 1 [* 50:100]
+    cp1.start_with_consecutive<50, 100>(a() == 1);
+    // b1 = 0 => 1 [-> 70:80] => 2
+    cp1.start_with(a() == 0)->goto_next<70, 80>(a() == 1)->next(a() == 2);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(long_repetition_test) {
+  long_repetition_covergroup cg{"covergroup8"};
+
+  std::vector<unsigned> values{0};
+  for (unsigned i = 0; i < 200; i++) values.push_back(i % 50 == 49 ? 3 : 1);
+  values.push_back(2);
+  sample_from_list(cg, cg.a, std::move(values));
+
+  // every run of 49 ones is too short for b0
+  BOOST_REQUIRE_EQUAL(cg.cp1.all_bins()[0]->hit_count(), 0);
+  // 196 ones in total, so the goto repetition has to stop at 80 hits
+  BOOST_REQUIRE_EQUAL(cg.cp1.all_bins()[1]->hit_count(), 0);
+
+  sample_from_list(cg, cg.a, std::vector<unsigned>(200, 1));
+  BOOST_REQUIRE_EQUAL(cg.cp1.all_bins()[0]->hit_count(), 151);
+
+  sample_from_list(cg, cg.a, {0, 1, 3, 1, 1});
+  sample_from_list(cg, cg.a, std::vector<unsigned>(68, 1));
+  sample_from_list(cg, cg.a, {2});
+  BOOST_REQUIRE_EQUAL(cg.cp1.all_bins()[1]->hit_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(coverage_db_merge_test) {
+  cross_covergroup cg{"covergroup9"};
+
+  for (unsigned i = 0; i < 8; i++) {
+    cg.a = i;
+    cg.b = i;
+    cg.sample();
+  }
+
+  crv_coverage_db db;
+  cg.save(db);
+  BOOST_REQUIRE(db.write("coverage_run1.cdb"));
+  BOOST_REQUIRE(db.write("coverage_run2.cdb"));
+  BOOST_REQUIRE(crv_coverage_db::merge_files({"coverage_run1.cdb", "coverage_run2.cdb"}, "coverage_merged.cdb"));
+
+  crv_coverage_db merged;
+  BOOST_REQUIRE(merged.read("coverage_merged.cdb"));
+  crv_coverage_db::record const* r = merged.find(cg.cp1.fullname());
+  BOOST_REQUIRE(r);
+  BOOST_REQUIRE_EQUAL(r->bins, 16);
+  BOOST_REQUIRE_EQUAL(r->hits.size(), 8);
+  BOOST_REQUIRE_EQUAL(r->hits[7].first, 7);
+  BOOST_REQUIRE_EQUAL(r->hits[7].second, 2);
+  r = merged.find(cg.cross.fullname());
+  BOOST_REQUIRE(r);
+  BOOST_REQUIRE_EQUAL(r->bins, 256);
+  BOOST_REQUIRE_EQUAL(r->hits.size(), 8);
+
+  cg.load(merged);
+  BOOST_REQUIRE_EQUAL(cg.cp1.simple_bins()[3].hit_count(), 3);
+  BOOST_REQUIRE_EQUAL(cg.cp1.simple_bins()[8].hit_count(), 0);
+  BOOST_REQUIRE_EQUAL(cg.cross.hit_count({5, 5}), 3);
+  BOOST_REQUIRE_EQUAL(cg.cross.covered_count(), 8);
+
+  BOOST_REQUIRE(!merged.read("coverage_missing.cdb"));
+  std::remove("coverage_run1.cdb");
+  std::remove("coverage_run2.cdb");
+  std::remove("coverage_merged.cdb");
+}
+
+BOOST_AUTO_TEST_CASE(async_sampling_test) {
+  range_covergroup cg{"covergroup10"};
+  cg.enable_async_sampling(16);
+
+  cg.b = 3;
+  for (unsigned i = 0; i < 1024; i++) {
+    cg.a = i;
+    cg.sample();
+  }
+  cg.flush();
+
+  std::vector<crv_bin>& bins = cg.cp1.simple_bins();
+  for (unsigned i = 0; i < 64; i++) BOOST_REQUIRE_EQUAL(bins[i].hit_count(), 16);
+  BOOST_REQUIRE_EQUAL(bins[64].hit_count(), 3);
+  BOOST_REQUIRE_EQUAL(bins[67].hit_count(), 1);
+
+  cg.a = 7;
+  cg.sample();
+  cg.disable_async_sampling();
+  BOOST_REQUIRE_EQUAL(bins[67].hit_count(), 2);
+
+  cg.sample();
+  BOOST_REQUIRE_EQUAL(bins[67].hit_count(), 3);
+
+  // pending samples are processed before the coverpoints are destroyed
+  for (unsigned k = 0; k < 16; k++) {
+    range_covergroup pending{"covergroup11"};
+    pending.enable_async_sampling(4);
+    for (unsigned i = 0; i < 256; i++) {
+      pending.a = i;
+      pending.sample();
+    }
+  }
+}
 
 BOOST_AUTO_TEST_SUITE_END()  // CoverageSampling
 
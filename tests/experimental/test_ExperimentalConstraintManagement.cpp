@@ -109,4 +109,92 @@ BOOST_AUTO_TEST_CASE(test2) {
   BOOST_REQUIRE(!it.item.randomize());
 }
 
+struct Item2 : public crv_sequence_item {
+  crv_variable<unsigned int> a;
+  crv_variable<unsigned int> b;
+  crv_variable<unsigned int> c;
+
+  crv_constraint range_a{a() < 10};
+  crv_constraint range_b{b() >= 20, b() <= 30};
+  crv_constraint range_c{c() > 100, c() < 110};
+  crv_constraint fixed_c{c() == 105};
+
+  Item2(crv_object_name) {}
+};
+
+BOOST_AUTO_TEST_CASE(toggle_keeps_generator) {
+  Item2 it("Item2");
+  it.fixed_c.deactivate();
+
+  for (int i = 0; i < 4; i++) {
+    BOOST_REQUIRE(it.randomize());
+    BOOST_REQUIRE_LT(it.a, 10);
+    BOOST_REQUIRE(it.b >= 20 && it.b <= 30);
+    BOOST_REQUIRE(it.c > 100 && it.c < 110);
+    if (i % 2) BOOST_REQUIRE_EQUAL(it.c, 105);
+
+    if (i % 2)
+      it.fixed_c.deactivate();
+    else
+      it.fixed_c.activate();
+  }
+
+  it.range_b.deactivate();
+  it.range_a.deactivate();
+  BOOST_REQUIRE(it.randomize_with(it.a() == 1000, it.b() == 1000));
+  BOOST_REQUIRE_EQUAL(it.a, 1000);
+  BOOST_REQUIRE_EQUAL(it.b, 1000);
+
+  it.range_a.activate();
+  BOOST_REQUIRE(!it.randomize_with(it.a() == 1000, it.b() == 1000));
+}
+
+struct Item3 : public crv_sequence_item {
+  crv_variable<unsigned int> a;
+  crv_variable<unsigned int> b;
+  crv_variable<unsigned int> c;
+
+  crv_constraint sum{a() + b() == 100, a() <= 100};
+  crv_constraint range_c{c() < 50};
+
+  Item3(crv_object_name) {}
+};
+
+BOOST_AUTO_TEST_CASE(rand_mode_keeps_values) {
+  Item3 it("Item3");
+  BOOST_REQUIRE(it.randomize());
+  BOOST_REQUIRE_EQUAL(it.a + it.b, 100);
+
+  it.b.rand_mode(false);
+  BOOST_REQUIRE(!it.b.rand_mode());
+  it.b = 30;
+  for (int i = 0; i < 4; i++) {
+    BOOST_REQUIRE(it.randomize());
+    BOOST_REQUIRE_EQUAL(it.a, 70);
+    BOOST_REQUIRE_EQUAL(it.b, 30);
+    BOOST_REQUIRE_LT(it.c, 50);
+  }
+  it.b = 200;
+  BOOST_REQUIRE(!it.randomize());
+
+  // all variables frozen, the constraints are only checked
+  it.a.rand_mode(false);
+  it.c.rand_mode(false);
+  it.a = 60;
+  it.b = 40;
+  it.c = 7;
+  BOOST_REQUIRE(it.randomize());
+  BOOST_REQUIRE_EQUAL(it.a, 60);
+  BOOST_REQUIRE_EQUAL(it.c, 7);
+  it.c = 60;
+  BOOST_REQUIRE(!it.randomize());
+
+  it.a.rand_mode(true);
+  it.b.rand_mode(true);
+  it.c.rand_mode(true);
+  BOOST_REQUIRE(it.randomize());
+  BOOST_REQUIRE_EQUAL(it.a + it.b, 100);
+  BOOST_REQUIRE_LT(it.c, 50);
+}
+
 BOOST_AUTO_TEST_SUITE_END()  // ConstraintManagement
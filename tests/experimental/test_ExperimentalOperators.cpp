@@ -581,4 +581,32 @@ BOOST_AUTO_TEST_CASE(divide) {
 
   VariableDefaultSolver::bypass_constraint_analysis = false;
 }
+
+struct s_array_reduction : public crv_sequence_item {
+  s_array_reduction(crv_object_name) {}
+  crv_array<unsigned char, 40> payload;
+  crv_variable<unsigned> len;
+  crv_constraint con = {len() == payload.sum(), len() >= 5000u, payload.and_reduce() == 0,
+                        payload.or_reduce() == 0xff, payload.xor_reduce() == 0x5a};
+};
+
+BOOST_AUTO_TEST_CASE(array_reduction) {
+  s_array_reduction item("item");
+  for (int i = 0; i < 5; i++) {
+    BOOST_REQUIRE(item.randomize());
+    unsigned sum = 0;
+    unsigned char a = 0xff, o = 0, x = 0;
+    for (unsigned j = 0; j < 40; j++) {
+      sum += item.payload[j];
+      a &= item.payload[j];
+      o |= item.payload[j];
+      x ^= item.payload[j];
+    }
+    BOOST_REQUIRE_EQUAL(item.len, sum);
+    BOOST_REQUIRE_GE(sum, 5000);
+    BOOST_REQUIRE_EQUAL(a, 0);
+    BOOST_REQUIRE_EQUAL(o, 0xff);
+    BOOST_REQUIRE_EQUAL(x, 0x5a);
+  }
+}
 BOOST_AUTO_TEST_SUITE_END()
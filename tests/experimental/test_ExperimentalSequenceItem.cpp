@@ -263,6 +263,86 @@ BOOST_AUTO_TEST_CASE(binary_search_test) {
   VariableDefaultSolver::bypass_constraint_analysis = false;
 }
 
+struct cached_item : public item1 {
+  cached_item(crv_object_name name) : item1(name) {}
+  unsigned cached_generators() const { return rand_with_cache_.size(); }
+};
+
+BOOST_AUTO_TEST_CASE(randomize_with_cache) {
+  cached_item it("it");
+  for (int i = 16; i <= 20; i++) {
+    BOOST_REQUIRE(it.randomize_with(it.a() == i, it.b() <= 2 * i));
+    BOOST_REQUIRE_EQUAL(it.a, i);
+    BOOST_REQUIRE_LE(it.b, 2 * i);
+    BOOST_REQUIRE(it.a + it.b == it.c);
+  }
+  BOOST_REQUIRE_EQUAL(it.cached_generators(), 1);
+
+  BOOST_REQUIRE(!it.randomize_with(it.a() == 30, it.b() <= 60));
+  BOOST_REQUIRE(it.randomize_with(it.a() > 18));
+  BOOST_REQUIRE_GT(it.a, 18);
+  BOOST_REQUIRE_EQUAL(it.cached_generators(), 2);
+
+  BOOST_REQUIRE(it.randomize_with(it.a() == 17, it.b() <= -3));
+  BOOST_REQUIRE_EQUAL(it.a, 17);
+  BOOST_REQUIRE_LE(it.b, -3);
+  BOOST_REQUIRE_EQUAL(it.cached_generators(), 3);
+  BOOST_REQUIRE(it.randomize_with(it.a() == 18, it.b() <= -30));
+  BOOST_REQUIRE_EQUAL(it.a, 18);
+  BOOST_REQUIRE_LE(it.b, -30);
+  BOOST_REQUIRE_EQUAL(it.cached_generators(), 3);
+
+  // read references created in each call are not cached
+  for (int i = 10; i < 15; i++) {
+    BOOST_REQUIRE(it.randomize_with(it.a() == reference(i)));
+    BOOST_REQUIRE_EQUAL(it.a, i);
+  }
+  BOOST_REQUIRE_EQUAL(it.cached_generators(), 3);
+}
+
+struct shared_item : public crv_sequence_item {
+  shared_item(crv_object_name) {}
+
+  crv_variable<unsigned> addr;
+  crv_variable<unsigned char> len;
+  crv_variable<int> kind;
+  crv_constraint range{addr() % 4 == 0, addr() + len() <= 4096u, len() > 0};
+  crv_constraint kinds{inside(kind(), std::set<int>{-1, 3, 7})};
+  crv_constraint small{len() <= 16};
+};
+
+BOOST_AUTO_TEST_CASE(shared_constraint_template) {
+  std::vector<std::unique_ptr<shared_item> > items;
+  for (int i = 0; i < 50; i++) items.emplace_back(new shared_item("item"));
+  items[7]->small.deactivate();
+
+  for (auto& it : items) BOOST_REQUIRE(it->randomize());
+
+  for (unsigned i = 0; i < items.size(); i++) {
+    shared_item const& it = *items[i];
+    BOOST_REQUIRE_EQUAL(it.addr % 4, 0);
+    BOOST_REQUIRE_LE(it.addr + it.len, 4096);
+    BOOST_REQUIRE_GT(it.len, 0);
+    BOOST_REQUIRE(it.kind == -1 || it.kind == 3 || it.kind == 7);
+    if (i != 7) BOOST_REQUIRE_LE(it.len, 16);
+  }
+
+  // randomizing one instance leaves the others untouched
+  unsigned addr = items[1]->addr;
+  for (int i = 0; i < 10; i++) BOOST_REQUIRE(items[0]->randomize());
+  BOOST_REQUIRE_EQUAL(items[1]->addr, addr);
+
+  // the template is released with its last instance and removes its three write slots from the variable container
+  std::size_t writes = variable_container()->write_references.size();
+  items.clear();
+  BOOST_REQUIRE_EQUAL(variable_container()->write_references.size(), writes - 3);
+
+  shared_item a("a"), b("b");
+  BOOST_REQUIRE(a.randomize());
+  BOOST_REQUIRE(b.randomize());
+  BOOST_REQUIRE_LE(b.len, 16);
+}
+
 struct Item2 : public crv_sequence_item {
   Item2(crv_object_name) {}
 